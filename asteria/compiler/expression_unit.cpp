@@ -15,7 +15,7 @@ namespace asteria {
 namespace {
 
 cow_vector<AIR_Node>
-do_generate_code_branch(const Compiler_Options& opts, const Global_Context& global,
+do_generate_code_branch(const Compiler_Options& opts, Global_Context& global,
                         Analytic_Context& ctx, PTC_Aware ptc,
                         const cow_vector<Expression_Unit>& units)
   {
@@ -36,7 +36,7 @@ do_generate_code_branch(const Compiler_Options& opts, const Global_Context& glob
 cow_vector<AIR_Node>&
 Expression_Unit::
 generate_code(cow_vector<AIR_Node>& code, const Compiler_Options& opts,
-              const Global_Context& global, Analytic_Context& ctx, PTC_Aware ptc) const
+              Global_Context& global, Analytic_Context& ctx, PTC_Aware ptc) const
   {
     switch(this->index()) {
       case index_literal: {
@@ -64,8 +64,11 @@ generate_code(cow_vector<AIR_Node>& code, const Compiler_Options& opts,
           qref = qctx->get_named_reference_with_hint_opt(hint, altr.name);
           if(qref) {
             // A reference declared later has been found.
-            // Record the context depth for later lookups.
-            AIR_Node::S_push_local_reference xnode = { altr.sloc, depth, hint, altr.name };
+            // Record the context depth and frame slot for later lookups.
+            // All contexts in this chain are analytic.
+            ROCKET_ASSERT(qctx->is_analytic());
+            uint32_t slot = static_cast<Analytic_Context*>(qctx)->find_local_slot(altr.name);
+            AIR_Node::S_push_local_reference xnode = { altr.sloc, depth, slot, altr.name };
             code.emplace_back(::std::move(xnode));
             return code;
           }
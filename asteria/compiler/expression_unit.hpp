@@ -178,7 +178,7 @@ class Expression_Unit
 
     cow_vector<AIR_Node>&
     generate_code(cow_vector<AIR_Node>& code, const Compiler_Options& opts,
-                  const Global_Context& global, Analytic_Context& ctx, PTC_Aware ptc) const;
+                  Global_Context& global, Analytic_Context& ctx, PTC_Aware ptc) const;
   };
 
 inline
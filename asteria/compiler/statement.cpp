@@ -13,19 +13,11 @@
 namespace asteria {
 namespace {
 
-void
-do_user_declare(cow_vector<phsh_string>* names_opt, Analytic_Context& ctx,
-                const phsh_string& name)
+uint32_t
+do_user_declare(Analytic_Context& ctx, const phsh_string& name)
   {
-    if(name.empty())
-      return;
-
-    // Record this name.
-    if(names_opt && !::rocket::find(*names_opt, name))
-      names_opt->emplace_back(name);
-
-    // Just ensure the name exists.
-    ctx.mut_named_reference(name).set_invalid();
+    // Assign a frame slot to this name.
+    return ctx.declare_local(name);
   }
 
 cow_vector<AIR_Node>&
@@ -38,7 +30,7 @@ do_generate_clear_stack(cow_vector<AIR_Node>& code)
 
 cow_vector<AIR_Node>&
 do_generate_subexpression(cow_vector<AIR_Node>& code, const Compiler_Options& opts,
-                          const Global_Context& global, Analytic_Context& ctx,
+                          Global_Context& global, Analytic_Context& ctx,
                           PTC_Aware ptc, const Statement::S_expression& expr)
   {
     // Generate a single-step trap if it is not disabled.
@@ -60,7 +52,7 @@ do_generate_subexpression(cow_vector<AIR_Node>& code, const Compiler_Options& op
 
 cow_vector<AIR_Node>&
 do_generate_expression(cow_vector<AIR_Node>& code, const Compiler_Options& opts,
-                       const Global_Context& global, Analytic_Context& ctx,
+                       Global_Context& global, Analytic_Context& ctx,
                        PTC_Aware ptc, const Statement::S_expression& expr)
   {
     do_generate_clear_stack(code);
@@ -69,7 +61,7 @@ do_generate_expression(cow_vector<AIR_Node>& code, const Compiler_Options& opts,
   }
 
 cow_vector<AIR_Node>
-do_generate_expression(const Compiler_Options& opts, const Global_Context& global,
+do_generate_expression(const Compiler_Options& opts, Global_Context& global,
                        Analytic_Context& ctx, PTC_Aware ptc,
                        const Statement::S_expression& expr)
   {
@@ -79,40 +71,59 @@ do_generate_expression(const Compiler_Options& opts, const Global_Context& globa
   }
 
 cow_vector<AIR_Node>&
-do_generate_statement_list(cow_vector<AIR_Node>& code, cow_vector<phsh_string>* names_opt,
-                           const Global_Context& global, Analytic_Context& ctx,
-                           const Compiler_Options& opts, PTC_Aware ptc,
-                           const Statement::S_block& block)
+do_generate_statement_list(cow_vector<AIR_Node>& code, Global_Context& global,
+                           Analytic_Context& ctx, const Compiler_Options& opts,
+                           PTC_Aware ptc, const Statement::S_block& block)
   {
     if(block.stmts.empty())
       return code;
 
     // Statements other than the last one cannot be the end of function.
     for(size_t i = 0;  i + 1 < block.stmts.size();  ++i)
-      block.stmts.at(i).generate_code(code, names_opt, global, ctx, opts,
+      block.stmts.at(i).generate_code(code, global, ctx, opts,
               block.stmts.at(i + 1).is_empty_return() ? ptc_aware_void : ptc_aware_none);
 
-    block.stmts.back().generate_code(code, names_opt, global, ctx, opts, ptc);
+    block.stmts.back().generate_code(code, global, ctx, opts, ptc);
     return code;
   }
 
 cow_vector<AIR_Node>
-do_generate_statement_list(cow_vector<phsh_string>* names_opt, const Global_Context& global,
-                           Analytic_Context& ctx, const Compiler_Options& opts,
-                           PTC_Aware ptc, const Statement::S_block& block)
+do_generate_statement_list(Global_Context& global, Analytic_Context& ctx,
+                           const Compiler_Options& opts, PTC_Aware ptc,
+                           const Statement::S_block& block)
   {
     cow_vector<AIR_Node> code;
-    do_generate_statement_list(code, names_opt, global, ctx, opts, ptc, block);
+    do_generate_statement_list(code, global, ctx, opts, ptc, block);
     return code;
   }
 
+bool
+do_is_scope_free(const Statement::S_block& block)
+  {
+    // A block is scope-free if it declares nothing and defers nothing.
+    return ::rocket::none_of(block.stmts,
+        [&](const Statement& stmt) {
+          return ::rocket::is_any_of(stmt.index(), { Statement::index_variables,
+                     Statement::index_function, Statement::index_defer,
+                     Statement::index_references });
+        });
+  }
+
 cow_vector<AIR_Node>
-do_generate_block(const Compiler_Options& opts, const Global_Context& global,
+do_generate_block(const Compiler_Options& opts, Global_Context& global,
                   Analytic_Context& ctx, PTC_Aware ptc, const Statement::S_block& block)
   {
+    // If the block is scope-free, generate code in the enclosing context, so
+    // no context will be created at runtime.
     cow_vector<AIR_Node> code;
+    if(do_is_scope_free(block))
+      return do_generate_statement_list(code, global, ctx, opts, ptc, block);
+
+    // Otherwise, mark it with a block node, which creates a context of its own.
     Analytic_Context ctx_stmts(Analytic_Context::M_plain(), ctx);
-    do_generate_statement_list(code, nullptr, global, ctx_stmts, opts, ptc, block);
+    AIR_Node::S_execute_block xnode;
+    do_generate_statement_list(xnode.code_body, global, ctx_stmts, opts, ptc, block);
+    code.emplace_back(::std::move(xnode));
     return code;
   }
 
@@ -120,9 +131,8 @@ do_generate_block(const Compiler_Options& opts, const Global_Context& global,
 
 cow_vector<AIR_Node>&
 Statement::
-generate_code(cow_vector<AIR_Node>& code, cow_vector<phsh_string>* names_opt,
-              const Global_Context& global, Analytic_Context& ctx,
-              const Compiler_Options& opts, PTC_Aware ptc) const
+generate_code(cow_vector<AIR_Node>& code, Global_Context& global,
+              Analytic_Context& ctx, const Compiler_Options& opts, PTC_Aware ptc) const
   {
     switch(this->index()) {
       case index_expression: {
@@ -138,10 +148,7 @@ generate_code(cow_vector<AIR_Node>& code, cow_vector<phsh_string>* names_opt,
 
         // Generate code for the body. This can be PTC'd.
         auto code_body = do_generate_block(opts, global, ctx, ptc, altr);
-
-        // Encode arguments.
-        AIR_Node::S_execute_block xnode = { ::std::move(code_body) };
-        code.emplace_back(::std::move(xnode));
+        code.append(code_body.move_begin(), code_body.move_end());
         return code;
       }
 
@@ -178,14 +185,16 @@ generate_code(cow_vector<AIR_Node>& code, cow_vector<phsh_string>* names_opt,
             ROCKET_ASSERT(altr.decls[i].size() == 1);
 
           // Create dummy references for further name lookups.
+          cow_vector<uint32_t> slots;
           for(size_t k = bpos;  k < epos;  ++k)
-            do_user_declare(names_opt, ctx, altr.decls[i][k]);
+            slots.emplace_back(do_user_declare(ctx, altr.decls[i][k]));
 
           if(altr.inits[i].units.empty()) {
             // If no initializer is provided, no further initialization is required.
             for(size_t k = bpos;  k < epos;  ++k) {
               AIR_Node::S_define_null_variable xnode = { altr.immutable, altr.slocs[i],
-                                                         altr.decls[i][k] };
+                                                         slots[k - bpos], altr.decls[i][k],
+                                                         false };
               code.emplace_back(::std::move(xnode));
             }
           }
@@ -195,7 +204,8 @@ generate_code(cow_vector<AIR_Node>& code, cow_vector<phsh_string>* names_opt,
 
             // Push uninitialized variables from left to right.
             for(size_t k = bpos;  k < epos;  ++k) {
-              AIR_Node::S_declare_variable xnode = { altr.slocs[i], altr.decls[i][k] };
+              AIR_Node::S_declare_variable xnode = { altr.slocs[i], slots[k - bpos],
+                                                     altr.decls[i][k], false };
               code.emplace_back(::std::move(xnode));
             }
 
@@ -227,10 +237,10 @@ generate_code(cow_vector<AIR_Node>& code, cow_vector<phsh_string>* names_opt,
         const auto& altr = this->m_stor.as<index_function>();
 
         // Create a dummy reference for further name lookups.
-        do_user_declare(names_opt, ctx, altr.name);
+        uint32_t slot = do_user_declare(ctx, altr.name);
 
         // Declare the function, which is effectively an immutable variable.
-        AIR_Node::S_declare_variable xnode_decl = { altr.sloc, altr.name };
+        AIR_Node::S_declare_variable xnode_decl = { altr.sloc, slot, altr.name, false };
         code.emplace_back(::std::move(xnode_decl));
 
         // Generate code
@@ -278,12 +288,12 @@ generate_code(cow_vector<AIR_Node>& code, cow_vector<phsh_string>* names_opt,
         // Generate code for all clauses.
         cow_vector<cow_vector<AIR_Node>> code_labels;
         cow_vector<cow_vector<AIR_Node>> code_bodies;
-        cow_vector<cow_vector<phsh_string>> names_added;
 
         // Create a fresh context for the `switch` body.
         // Be advised that all clauses inside a `switch` statement share the same context.
+        // Variables that are bypassed by a jump to a later clause occupy frame slots
+        // which are never written, so they are still invalid at runtime.
         Analytic_Context ctx_body(Analytic_Context::M_plain(), ctx);
-        cow_vector<phsh_string> names;
 
         // Get the number of clauses.
         auto nclauses = altr.labels.size();
@@ -295,17 +305,14 @@ generate_code(cow_vector<AIR_Node>& code, cow_vector<phsh_string>* names_opt,
           do_generate_expression(code_labels.emplace_back(), opts, global, ctx, ptc_aware_none,
                                  altr.labels[i]);
 
-          // Generate code for the clause and accumulate names.
+          // Generate code for the clause.
           // This cannot be PTC'd.
-          do_generate_statement_list(code_bodies.emplace_back(), &names, global, ctx_body, opts,
+          do_generate_statement_list(code_bodies.emplace_back(), global, ctx_body, opts,
                                      ptc_aware_none, altr.bodies[i]);
-
-          names_added.emplace_back(names);
         }
 
         // Encode arguments.
-        AIR_Node::S_switch_statement xnode = { ::std::move(code_labels), ::std::move(code_bodies),
-                                               ::std::move(names_added) };
+        AIR_Node::S_switch_statement xnode = { ::std::move(code_labels), ::std::move(code_bodies) };
         code.emplace_back(::std::move(xnode));
         return code;
       }
@@ -352,8 +359,8 @@ generate_code(cow_vector<AIR_Node>& code, cow_vector<phsh_string>* names_opt,
         // Note that the key and value references outlasts every iteration, so we have to create
         // an outer contexts here.
         Analytic_Context ctx_for(Analytic_Context::M_plain(), ctx);
-        do_user_declare(names_opt, ctx_for, altr.name_key);
-        do_user_declare(names_opt, ctx_for, altr.name_mapped);
+        uint32_t slot_key = do_user_declare(ctx_for, altr.name_key);
+        uint32_t slot_mapped = do_user_declare(ctx_for, altr.name_mapped);
 
         // Generate code for the range initializer.
         ROCKET_ASSERT(!altr.init.units.empty());
@@ -364,8 +371,9 @@ generate_code(cow_vector<AIR_Node>& code, cow_vector<phsh_string>* names_opt,
         auto code_body = do_generate_block(opts, global, ctx_for, ptc_aware_none, altr.body);
 
         // Encode arguments.
-        AIR_Node::S_for_each_statement xnode = { altr.name_key, altr.name_mapped,
-                                                 ::std::move(code_init), ::std::move(code_body) };
+        AIR_Node::S_for_each_statement xnode = { slot_key, altr.name_key, slot_mapped,
+                                                 altr.name_mapped, ::std::move(code_init),
+                                                 ::std::move(code_body) };
         code.emplace_back(::std::move(xnode));
         return code;
       }
@@ -378,8 +386,8 @@ generate_code(cow_vector<AIR_Node>& code, cow_vector<phsh_string>* names_opt,
         Analytic_Context ctx_for(Analytic_Context::M_plain(), ctx);
 
         // Generate code for the initializer, the condition and the loop increment.
-        auto code_init = do_generate_statement_list(nullptr, global, ctx_for, opts,
-                                                    ptc_aware_none, altr.init);
+        auto code_init = do_generate_statement_list(global, ctx_for, opts, ptc_aware_none,
+                                                    altr.init);
         auto code_cond = do_generate_expression(opts, global, ctx_for, ptc_aware_none, altr.cond);
         auto code_step = do_generate_expression(opts, global, ctx_for, ptc_aware_none, altr.step);
 
@@ -402,17 +410,18 @@ generate_code(cow_vector<AIR_Node>& code, cow_vector<phsh_string>* names_opt,
 
         // Create a fresh context for the `catch` clause.
         Analytic_Context ctx_catch(Analytic_Context::M_plain(), ctx);
-        do_user_declare(names_opt, ctx_catch, altr.name_except);
+        uint32_t slot_except = do_user_declare(ctx_catch, altr.name_except);
         ctx_catch.mut_named_reference(sref("__backtrace"));
 
         // Generate code for the `catch` body.
         // Unlike the `try` body, this may be PTC'd.
-        auto code_catch = do_generate_statement_list(nullptr, global, ctx_catch, opts, ptc,
+        auto code_catch = do_generate_statement_list(global, ctx_catch, opts, ptc,
                                                      altr.body_catch);
 
         // Encode arguments.
         AIR_Node::S_try_statement xnode = { altr.sloc_try, ::std::move(code_try), altr.sloc_catch,
-                                            altr.name_except, ::std::move(code_catch) };
+                                            slot_except, altr.name_except,
+                                            ::std::move(code_catch), true };
         code.emplace_back(::std::move(xnode));
         return code;
       }
@@ -564,17 +573,17 @@ generate_code(cow_vector<AIR_Node>& code, cow_vector<phsh_string>* names_opt,
         for(size_t i = 0;  i < nvars;  ++i) {
           // Note that references don't support structured bindings.
           // Create a dummy references for further name lookups.
-          do_user_declare(names_opt, ctx, altr.names[i]);
+          uint32_t slot = do_user_declare(ctx, altr.names[i]);
 
           // Declare a void reference.
-          AIR_Node::S_declare_reference xnode_decl = { altr.names[i] };
+          AIR_Node::S_declare_reference xnode_decl = { slot, altr.names[i] };
           code.emplace_back(::std::move(xnode_decl));
 
           // Generate code for the initializer.
           do_generate_expression(code, opts, global, ctx, ptc_aware_none, altr.inits[i]);
 
           // Initialize the reference.
-          AIR_Node::S_initialize_reference xnode_init = { altr.slocs[i], altr.names[i] };
+          AIR_Node::S_initialize_reference xnode_init = { altr.slocs[i], slot, altr.names[i] };
           code.emplace_back(::std::move(xnode_init));
         }
         return code;
@@ -39,6 +39,7 @@ using Destructor   = void (Header* head);
 using Executor     = AIR_Status (Executive_Context& ctx, const Header* head);
 using Var_Getter   = void (Variable_HashMap& staged, Variable_HashMap& temp,
                            const Header* head);
+using Jit_Compiler = void (Header* head);
 
 struct Metadata
   {
@@ -46,10 +47,14 @@ struct Metadata
     Relocator* reloc_opt;  // if null then bitwise copy is performed
     Destructor* dtor_opt;  // if null then no cleanup is performed
     Var_Getter* vget_opt;  // if null then no variable shall exist
+    Jit_Compiler* jit_opt;  // if null then no nested queue shall exist
     Executor* exec;        // executor function, must not be null
 
     // Version 2
-    Source_Location syms;  // symbols
+    uint32_t file_off;     // symbols; the file name is interned by the queue
+    uint32_t file_len;
+    int line;
+    int column;
   };
 
 // This is the header of each variable-length element that is stored in an AVMC
@@ -124,6 +129,33 @@ struct select_get_variables<SparamT,
       { return do_call_get_variables<SparamT>;  }
   };
 
+template<typename SparamT>
+inline
+void
+do_call_jit_compile(Header* head)
+  {
+    auto ptr = reinterpret_cast<SparamT*>(head->sparam);
+    ptr->jit_compile();
+  }
+
+template<typename SparamT, typename = void>
+struct select_jit_compile
+  {
+    constexpr operator
+    Jit_Compiler*() const noexcept
+      { return nullptr;  }
+  };
+
+template<typename SparamT>
+struct select_jit_compile<SparamT,
+    ROCKET_VOID_DECLTYPE(
+      ::std::declval<SparamT&>().jit_compile())>
+  {
+    constexpr operator
+    Jit_Compiler*() const noexcept
+      { return do_call_jit_compile<SparamT>;  }
+  };
+
 template<typename SparamT>
 struct Sparam_traits
   {
@@ -139,6 +171,9 @@ struct Sparam_traits
 
     static constexpr Var_Getter* vget_opt =
         select_get_variables<SparamT>();
+
+    static constexpr Jit_Compiler* jit_opt =
+        select_jit_compile<SparamT>();
   };
 
 template<typename XSparamT>
@@ -0,0 +1,32 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2022, LH_Mouse. All wrongs reserved.
+
+#ifndef ASTERIA_LLDS_VARIABLE_SLAB_
+#  error Please include <asteria/llds/variable_slab.hpp> instead.
+#endif
+namespace asteria {
+namespace details_variable_slab {
+
+struct Chunk;
+
+struct Slot
+  {
+    Chunk* chunk;  // null if allocated from the heap
+
+    union {
+      Slot* next;  // the next free slot; valid iff this slot is free
+      alignas(Variable) char stor[sizeof(Variable)];
+    };
+  };
+
+struct Chunk
+  {
+    Variable_Slab* owner;  // null if the slab has been destroyed
+    Chunk* prev;           // list of chunks of the same slab
+    Chunk* next;
+    Slot* free;            // the first free slot
+    size_t nlive;          // number of slots in use
+  };
+
+}  // namespace details_variable_slab
+}  // namespace asteria
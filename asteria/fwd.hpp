@@ -151,6 +151,8 @@ class Simple_Script;
 
 // Low-level data structures
 class Variable_HashMap;
+class Variable_List;
+class Variable_Slab;
 class Reference_Dictionary;
 class Reference_Stack;
 class AVMC_Queue;
@@ -172,6 +174,7 @@ class Global_Context;
 class Garbage_Collector;
 class Random_Engine;
 class Module_Loader;
+class Call_Pool;
 class Variadic_Arguer;
 class Instantiated_Function;
 class AIR_Node;
@@ -869,6 +872,10 @@ template<>
 struct Compiler_Options_fragment<2>
   {
     // Note: Please keep this struct as compact as possible.
+
+    // Translate function bodies into native code.
+    // This is only supported on x86-64. On other targets code is interpreted.
+    bool jit_compilation = false;
   };
 
 // These are aliases for historical versions.
@@ -265,33 +265,17 @@ V_array
 std_array_replace_slice(V_array data, V_integer from, optV_integer length,
                         V_array replacement, optV_integer rfrom, optV_integer rlength)
   {
-    V_array res = data;
-    auto range = do_slice(res, from, length);
+    auto range = do_slice(data, from, length);
     auto rep_range = do_slice(replacement, rfrom.value_or(0), rlength);
 
-    // Convert iterators to subscripts.
-    auto offset = ::std::distance(res.begin(), range.first);
-    auto dist = ::std::distance(range.first, range.second);
-    auto rep_offset = ::std::distance(replacement.begin(), rep_range.first);
-    auto rep_dist = ::std::distance(rep_range.first, rep_range.second);
-
-    if(dist >= replacement.ssize()) {
-      // Overwrite the subrange in place.
-      auto insp = ::std::move(replacement.mut_begin() + rep_offset,
-                              replacement.mut_begin() + rep_offset + rep_dist,
-                              res.mut_begin() + offset);
-
-      res.erase(insp, res.begin() + offset + dist);
-    }
-    else {
-      // Extend the range.
-      auto insp = ::std::move(replacement.mut_begin() + rep_offset,
-                              replacement.mut_begin() + rep_offset + dist,
-                              res.mut_begin() + offset);
-
-      res.insert(insp, replacement.move_begin() + rep_offset + dist,
-                       replacement.move_begin() + rep_offset + rep_dist);
-    }
+    // Build the result in a single pass. As both arguments usually share
+    // storage with the caller, modifying them in place would copy them first.
+    V_array res;
+    res.reserve(data.size() - static_cast<size_t>(range.second - range.first)
+                + static_cast<size_t>(rep_range.second - rep_range.first));
+    res.append(data.begin(), range.first);
+    res.append(rep_range.first, rep_range.second);
+    res.append(range.second, data.end());
     return res;
   }
 
@@ -253,6 +253,17 @@ do_conf_parse_value_nonrecursive(Token_Stream& tstrm)
     }
   }
 
+template<size_t N>
+V_array
+do_make_counter_array(const ::std::array<uint64_t, N>& counters)
+  {
+    V_array arr;
+    arr.reserve(N);
+    for(uint64_t n : counters)
+      arr.emplace_back(static_cast<int64_t>(::rocket::min(n, (uint64_t) INT64_MAX)));
+    return arr;
+  }
+
 }  // namespace
 
 V_integer
@@ -319,6 +330,39 @@ std_system_gc_collect(Global_Context& global, optV_integer generation_limit)
     return static_cast<int64_t>(nvars);
   }
 
+V_integer
+std_system_gc_step(Global_Context& global, V_integer budget)
+  {
+    if(budget <= 0)
+      ASTERIA_THROW_RUNTIME_ERROR((
+          "Invalid budget `$1`"),
+          budget);
+
+    // Perform a slice of incremental garbage collection.
+    const auto gcoll = global.garbage_collector();
+    auto rbudget = ::rocket::clamp_cast<size_t>(budget, 1, PTRDIFF_MAX);
+    size_t nvars = gcoll->collect_variables_step(rbudget);
+    return static_cast<int64_t>(nvars);
+  }
+
+V_object
+std_system_gc_stats(Global_Context& global)
+  {
+    const auto gcoll = global.garbage_collector();
+    const auto& stats = gcoll->get_statistics();
+
+    // Arrays of three elements are indexed by generation.
+    V_object result;
+    result.insert_or_assign(sref("cycles"), do_make_counter_array(stats.cycles));
+    result.insert_or_assign(sref("scanned"), do_make_counter_array(stats.scanned));
+    result.insert_or_assign(sref("collected"), do_make_counter_array(stats.collected));
+    result.insert_or_assign(sref("promoted"), do_make_counter_array(stats.promoted));
+    result.insert_or_assign(sref("pool_hits"), static_cast<int64_t>(stats.pool_hits));
+    result.insert_or_assign(sref("pool_misses"), static_cast<int64_t>(stats.pool_misses));
+    result.insert_or_assign(sref("pauses"), do_make_counter_array(stats.pauses));
+    return result;
+  }
+
 optV_string
 std_system_env_get_variable(V_string name)
   {
@@ -569,6 +613,33 @@ create_bindings_system(V_object& result, API_Version /*version*/)
         reader.throw_no_matching_function_call();
       });
 
+    result.insert_or_assign(sref("gc_step"),
+      ASTERIA_BINDING(
+        "std.system.gc_step", "budget",
+        Global_Context& global, Argument_Reader&& reader)
+      {
+        V_integer budget;
+
+        reader.start_overload();
+        reader.required(budget);
+        if(reader.end_overload())
+          return (Value) std_system_gc_step(global, budget);
+
+        reader.throw_no_matching_function_call();
+      });
+
+    result.insert_or_assign(sref("gc_stats"),
+      ASTERIA_BINDING(
+        "std.system.gc_stats", "",
+        Global_Context& global, Argument_Reader&& reader)
+      {
+        reader.start_overload();
+        if(reader.end_overload())
+          return (Value) std_system_gc_stats(global);
+
+        reader.throw_no_matching_function_call();
+      });
+
     result.insert_or_assign(sref("env_get_variable"),
       ASTERIA_BINDING(
         "std.system.env_get_variable", "name",
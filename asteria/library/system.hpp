@@ -23,6 +23,14 @@ std_system_gc_set_threshold(Global_Context& global, V_integer generation, V_inte
 V_integer
 std_system_gc_collect(Global_Context& global, optV_integer generation_limit);
 
+// `std.system.gc_step`
+V_integer
+std_system_gc_step(Global_Context& global, V_integer budget);
+
+// `std.system.gc_stats`
+V_object
+std_system_gc_stats(Global_Context& global);
+
 // `std.system.env_get_variable`
 optV_string
 std_system_env_get_variable(V_string name);
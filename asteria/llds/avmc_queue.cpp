@@ -7,7 +7,152 @@
 #include "../runtime/runtime_error.hpp"
 #include "../runtime/enums.hpp"
 #include "../utils.hpp"
+#if defined(__x86_64__) && defined(__ELF__)
+#  include <sys/mman.h>
+#  define ASTERIA_AVMC_JIT_X86_64_  1
+extern "C" void __register_frame(void* begin);
+extern "C" void __deregister_frame(void* begin);
+#endif
 namespace asteria {
+namespace {
+
+#ifdef ASTERIA_AVMC_JIT_X86_64_
+
+// This is the header of a block of native code. It is followed by unwind
+// information and machine instructions. The whole block is mapped read-only
+// and executable after it has been generated.
+struct Native_Block
+  {
+    size_t size;  // size of the mapping, including this header
+    size_t code;  // offset of the first instruction
+  };
+
+// The generated function has this signature. `qcur` is updated before each
+// node is executed, so the faulting node is known if an exception is thrown.
+using Native_Function = AIR_Status (Executive_Context& ctx,
+                                    const details_avmc_queue::Header** qcur);
+
+// Generated code looks like this:
+//
+//   push rbp                 ; 55
+//   mov rbp, rsp             ; 48 89 E5
+//   push rbx                 ; 53
+//   push r12                 ; 41 54
+//   mov rbx, rdi             ; 48 89 FB
+//   mov r12, rsi             ; 49 89 F4
+//
+// For each node:
+//   mov rsi, <node>          ; 48 BE <imm64>
+//   mov [r12], rsi           ; 49 89 34 24
+//   mov rdi, rbx             ; 48 89 DF
+//   mov rax, [rsi+8]         ; 48 8B 46 08      (`pv_exec` or `pv_meta`)
+//   mov rax, [rax+32]        ; 48 8B 40 20      (`exec`, if `pv_meta`)
+//     -or-
+//   nop dword [rax]          ; 0F 1F 40 00      (if `pv_exec`)
+//   call rax                 ; FF D0
+//   test al, al              ; 84 C0
+//   jnz .exit                ; 0F 85 <rel32>
+//
+//   xor eax, eax             ; 31 C0
+// .exit:
+//   pop r12                  ; 41 5C
+//   pop rbx                  ; 5B
+//   pop rbp                  ; 5D
+//   ret                      ; C3
+//
+// Executors are loaded from nodes when they are called, as a node may rewrite
+// its own executor, such as when it specializes itself for types of operands.
+// Executors may throw exceptions, so unwind information is registered for
+// generated code. As it does not catch exceptions, no personality routine is
+// required.
+constexpr unsigned char s_native_prologue[] =
+  {
+    0x55, 0x48, 0x89, 0xE5, 0x53, 0x41, 0x54, 0x48, 0x89, 0xFB,
+    0x49, 0x89, 0xF4,
+  };
+
+constexpr unsigned char s_native_epilogue[] =
+  {
+    0x31, 0xC0, 0x41, 0x5C, 0x5B, 0x5D, 0xC3,
+  };
+
+constexpr size_t s_native_node_size = 35;
+
+static_assert(offsetof(details_avmc_queue::Header, pv_exec) == 8);
+static_assert(offsetof(details_avmc_queue::Header, pv_meta) == 8);
+static_assert(offsetof(details_avmc_queue::Metadata, exec) == 32);
+
+// This is a CIE and an FDE in `.eh_frame` format, terminated by a zero
+// length. PC begin and PC range of the FDE are filled in later.
+constexpr unsigned char s_native_eh_frame[] =
+  {
+    // CIE
+    0x14, 0x00, 0x00, 0x00,  // length
+    0x00, 0x00, 0x00, 0x00,  // CIE ID
+    0x01,                    // version
+    'z', 'R', 0x00,          // augmentation
+    0x01,                    // code alignment factor
+    0x78,                    // data alignment factor (-8)
+    0x10,                    // return address register (rip)
+    0x01,                    // augmentation data length
+    0x00,                    // FDE pointer encoding (DW_EH_PE_absptr)
+    0x0C, 0x07, 0x08,        // DW_CFA_def_cfa: rsp + 8
+    0x90, 0x01,              // DW_CFA_offset: rip at CFA - 8
+    0x00, 0x00,              // DW_CFA_nop
+
+    // FDE
+    0x2C, 0x00, 0x00, 0x00,  // length
+    0x1C, 0x00, 0x00, 0x00,  // CIE pointer
+    0, 0, 0, 0, 0, 0, 0, 0,  // PC begin (offset 32)
+    0, 0, 0, 0, 0, 0, 0, 0,  // PC range (offset 40)
+    0x00,                    // augmentation data length
+    0x41,                    // DW_CFA_advance_loc: 1 (push rbp)
+    0x0E, 0x10,              // DW_CFA_def_cfa_offset: 16
+    0x86, 0x02,              // DW_CFA_offset: rbp at CFA - 16
+    0x43,                    // DW_CFA_advance_loc: 3 (mov rbp, rsp)
+    0x0D, 0x06,              // DW_CFA_def_cfa_register: rbp
+    0x41,                    // DW_CFA_advance_loc: 1 (push rbx)
+    0x83, 0x03,              // DW_CFA_offset: rbx at CFA - 24
+    0x42,                    // DW_CFA_advance_loc: 2 (push r12)
+    0x8C, 0x04,              // DW_CFA_offset: r12 at CFA - 32
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // DW_CFA_nop
+
+    // terminator
+    0x00, 0x00, 0x00, 0x00,
+  };
+
+constexpr size_t s_native_pc_begin_offset = 32;
+constexpr size_t s_native_pc_range_offset = 40;
+
+inline
+unsigned char*
+do_put_bytes(unsigned char* wptr, const void* data, size_t size) noexcept
+  {
+    ::std::memcpy(wptr, data, size);
+    return wptr + size;
+  }
+
+template<typename ValueT>
+inline
+unsigned char*
+do_put_value(unsigned char* wptr, ValueT value) noexcept
+  {
+    return do_put_bytes(wptr, &value, sizeof(value));
+  }
+
+#endif  // ASTERIA_AVMC_JIT_X86_64_
+
+// Executors may be rewritten by other threads, so they are accessed atomically.
+// Either the old one or the new one is called, and both are correct.
+inline
+details_avmc_queue::Executor*
+do_load_executor(const details_avmc_queue::Header* qnode) noexcept
+  {
+    return qnode->meta_ver ? __atomic_load_n(&(qnode->pv_meta->exec), __ATOMIC_RELAXED)
+                           : __atomic_load_n(&(qnode->pv_exec), __ATOMIC_RELAXED);
+  }
+
+}  // namespace
 
 void
 AVMC_Queue::
@@ -22,30 +167,36 @@ do_destroy_nodes(bool xfree) noexcept
       // Destroy `sparam`, if any.
       if(qnode->meta_ver && qnode->pv_meta->dtor_opt)
         qnode->pv_meta->dtor_opt(qnode);
-
-      // Deallocate the vtable and symbols.
-      if(qnode->meta_ver)
-        delete qnode->pv_meta;
     }
 
 #ifdef ROCKET_DEBUG
     ::std::memset(this->m_bptr, 0xE6, this->m_estor * sizeof(Header));
+    ::std::memset(this->m_mptr, 0xE6, this->m_mestor * sizeof(Metadata));
 #endif
 
     this->m_used = 0xDEADBEEF;
+    this->m_mused = 0xDEADBEEF;
     if(!xfree)
       return;
 
-    // Deallocate the old table.
+    // Deallocate the old tables.
     auto bold = ::std::exchange(this->m_bptr, (Header*)0xDEADBEEF);
     auto esold = ::std::exchange(this->m_estor, (size_t)0xBEEFDEAD);
     ::rocket::freeN<Header>(bold, esold);
+
+    auto mold = ::std::exchange(this->m_mptr, (Metadata*)0xDEADBEEF);
+    auto msold = ::std::exchange(this->m_mestor, (size_t)0xBEEFDEAD);
+    ::rocket::freeN<Metadata>(mold, msold);
   }
 
 void
 AVMC_Queue::
 do_reallocate(uint32_t nadd)
   {
+    // Native code refers to nodes by address, so it has to be discarded.
+    if(this->m_native)
+      this->do_free_native();
+
     // Allocate a new table.
     constexpr size_t nheaders_max = UINT32_MAX / sizeof(Header);
     if(nheaders_max - this->m_used < nadd)
@@ -80,6 +231,98 @@ do_reallocate(uint32_t nadd)
     ::rocket::freeN<Header>(bold, esold);
   }
 
+void
+AVMC_Queue::
+do_reallocate_metadata(uint32_t nadd)
+  {
+    // Allocate a new table.
+    constexpr size_t nmeta_max = UINT32_MAX / sizeof(Metadata);
+    if(nmeta_max - this->m_mused < nadd)
+      throw ::std::bad_alloc();
+
+    uint32_t mestor = this->m_mused + nadd;
+    auto mptr = ::rocket::allocN<Metadata>(mestor);
+
+    // Metadata are trivial, so they can be copied bitwise.
+    auto mold = ::std::exchange(this->m_mptr, mptr);
+    ::std::memcpy(mptr, mold, this->m_mused * sizeof(Metadata));
+    auto msold = ::std::exchange(this->m_mestor, mestor);
+    if(ROCKET_EXPECT(!mold))
+      return;
+
+    // Make nodes point to the new table.
+    auto next = this->m_bptr;
+    const auto eptr = this->m_bptr + this->m_used;
+    while(ROCKET_EXPECT(next != eptr)) {
+      auto qnode = next;
+      next += UINT32_C(1) + qnode->nheaders;
+
+      if(qnode->meta_ver)
+        qnode->pv_meta = mptr + (qnode->pv_meta - mold);
+    }
+
+    // Deallocate the old table.
+    ::rocket::freeN<Metadata>(mold, msold);
+  }
+
+uint32_t
+AVMC_Queue::
+do_intern_file(const cow_string& file)
+  {
+    // Nodes in a queue usually come from the same file, whose name is shared
+    // with the first source location without being copied.
+    if(ROCKET_EXPECT(this->m_files == file))
+      return 0;
+
+    if(this->m_files.empty()) {
+      this->m_files = file;
+      return 0;
+    }
+
+    // Search for the name. If it's not found, append it.
+    size_t off = 0;
+    for(;;) {
+      size_t end = this->m_files.find(off, '\0');
+      if(end == cow_string::npos)
+        end = this->m_files.size();
+
+      if((end - off == file.size())
+         && (::std::memcmp(this->m_files.data() + off, file.data(), file.size()) == 0))
+        return static_cast<uint32_t>(off);
+
+      if(end == this->m_files.size())
+        break;
+
+      off = end + 1;
+    }
+
+    if(this->m_files.size() + 1 + file.size() > UINT32_MAX)
+      throw ::std::bad_alloc();
+
+    off = this->m_files.size() + 1;
+    this->m_files.push_back('\0');
+    this->m_files.append(file);
+    return static_cast<uint32_t>(off);
+  }
+
+void
+AVMC_Queue::
+do_push_symbols_opt(Runtime_Error& except, const Header* qnode_opt) const
+  {
+    // Nodes with symbols have `meta_ver >= 2`. Symbols are stored in metadata,
+    // which is out of the way of execution, and are only read when an exception
+    // is thrown.
+    if(!qnode_opt || (qnode_opt->meta_ver < 2))
+      return;
+
+    const auto& meta = *(qnode_opt->pv_meta);
+    cow_string file = this->m_files;
+    if((meta.file_off != 0) || (meta.file_len != file.size()))
+      file.assign(this->m_files, meta.file_off, meta.file_len);
+
+    except.push_frame_plain(Source_Location(file, meta.line, meta.column), sref(""));
+  }
+
 details_avmc_queue::Header*
 AVMC_Queue::
 do_reserve_one(Uparam uparam, size_t size)
@@ -136,20 +379,36 @@ do_append_trivial(Uparam uparam, Executor* exec, size_t size, const void* data_o
 details_avmc_queue::Header*
 AVMC_Queue::
 do_append_nontrivial(Uparam uparam, Executor* exec, const Source_Location* sloc_opt,
-                     Var_Getter* vget_opt, Relocator* reloc_opt, Destructor* dtor_opt,
-                     size_t size, Constructor* ctor_opt, intptr_t ctor_arg)
+                     Var_Getter* vget_opt, Jit_Compiler* jit_opt, Relocator* reloc_opt,
+                     Destructor* dtor_opt, size_t size, Constructor* ctor_opt,
+                     intptr_t ctor_arg)
   {
-    // Allocate metadata for this node.
-    auto meta = ::rocket::make_unique<details_avmc_queue::Metadata>();
+    // Reserve metadata for this node. Metadata of all nodes are allocated
+    // contiguously, like nodes themselves.
+    if(ROCKET_UNEXPECT(this->m_mestor == this->m_mused)) {
+      uint32_t nadd = 1;
+#ifndef ROCKET_DEBUG
+      // Reserve more space for non-debug builds.
+      nadd |= this->m_mused * 2;
+#endif
+      this->do_reallocate_metadata(nadd);
+    }
+    ROCKET_ASSERT(this->m_mestor - this->m_mused >= 1);
+
+    details_avmc_queue::Metadata meta = { };
     uint8_t meta_ver = 1;
 
-    meta->reloc_opt = reloc_opt;
-    meta->dtor_opt = dtor_opt;
-    meta->vget_opt = vget_opt;
-    meta->exec = exec;
+    meta.reloc_opt = reloc_opt;
+    meta.dtor_opt = dtor_opt;
+    meta.vget_opt = vget_opt;
+    meta.jit_opt = jit_opt;
+    meta.exec = exec;
 
     if(sloc_opt) {
-      meta->syms = *sloc_opt;
+      meta.file_off = this->do_intern_file(sloc_opt->file());
+      meta.file_len = static_cast<uint32_t>(sloc_opt->file().size());
+      meta.line = sloc_opt->line();
+      meta.column = sloc_opt->column();
       meta_ver = 2;
     }
 
@@ -162,87 +421,223 @@ do_append_nontrivial(Uparam uparam, Executor* exec, const Source_Location* sloc_
       ::std::memset(qnode->sparam, 0, size);
 
     // Accept this node.
-    qnode->pv_meta = meta.release();
+    auto qmeta = this->m_mptr + this->m_mused;
+    ::std::memcpy(qmeta, &meta, sizeof(meta));
+    qnode->pv_meta = qmeta;
     qnode->meta_ver = meta_ver;
+    this->m_mused ++;
     this->m_used += UINT32_C(1) + qnode->nheaders;
     return qnode;
   }
 
+void
+AVMC_Queue::
+do_free_native() noexcept
+  {
+#ifdef ASTERIA_AVMC_JIT_X86_64_
+    auto block = static_cast<Native_Block*>(::std::exchange(this->m_native, nullptr));
+    __deregister_frame(block + 1);
+    ::munmap(block, block->size);
+#else
+    ROCKET_ASSERT(false);
+#endif
+  }
+
+AIR_Status
+AVMC_Queue::
+do_execute_native(Executive_Context& ctx) const
+  {
+#ifdef ASTERIA_AVMC_JIT_X86_64_
+    auto block = static_cast<const Native_Block*>(this->m_native);
+    auto func = reinterpret_cast<Native_Function*>(
+                    reinterpret_cast<uintptr_t>(block) + block->code);
+
+    // Execute all nodes in a single call. If an exception is thrown, `qnode`
+    // will point to the node that has thrown it.
+    const Header* qnode = nullptr;
+    try {
+      return func(ctx, &qnode);
+    }
+    catch(Runtime_Error& except) {
+      // Modify the exception in place and rethrow it without copying it.
+      this->do_push_symbols_opt(except, qnode);
+      throw;
+    }
+    catch(exception& stdex) {
+      // Replace the active exception.
+      Runtime_Error except(Runtime_Error::M_native(), cow_string(stdex.what()));
+      this->do_push_symbols_opt(except, qnode);
+      throw except;
+    }
+#else
+    (void) ctx;
+    ROCKET_UNREACHABLE();
+#endif
+  }
+
+size_t
+AVMC_Queue::
+count_nodes() const noexcept
+  {
+    size_t count = 0;
+    auto next = this->m_bptr;
+    const auto eptr = this->m_bptr + this->m_used;
+    while(ROCKET_EXPECT(next != eptr)) {
+      next += UINT32_C(1) + next->nheaders;
+      count ++;
+    }
+    return count;
+  }
+
+details_avmc_queue::Executor*
+AVMC_Queue::
+get_executor(size_t index) const noexcept
+  {
+    auto qnode = this->m_bptr;
+    for(size_t k = 0;  k != index;  ++k)
+      qnode += UINT32_C(1) + qnode->nheaders;
+
+    ROCKET_ASSERT(qnode < this->m_bptr + this->m_used);
+    return do_load_executor(qnode);
+  }
+
+void
+AVMC_Queue::
+rewrite_executor(const Header* head, Executor& exec) noexcept
+  {
+    // The queue may be shared, so this is a relaxed atomic store. Nodes are
+    // allocated dynamically and are never `const` objects, so it's safe to
+    // cast `const` away.
+    auto qnode = const_cast<Header*>(head);
+    if(qnode->meta_ver)
+      __atomic_store_n(&(qnode->pv_meta->exec), &exec, __ATOMIC_RELAXED);
+    else
+      __atomic_store_n(&(qnode->pv_exec), &exec, __ATOMIC_RELAXED);
+  }
+
 void
 AVMC_Queue::
 finalize()
   {
-    // TODO: Add JIT support.
     this->do_reallocate(0);
+
+    if(this->m_mestor != this->m_mused)
+      this->do_reallocate_metadata(0);
   }
 
-AIR_Status
+void
 AVMC_Queue::
-execute(Executive_Context& ctx) const
+jit_compile()
   {
+    // Compile nested queues first. They are executed by their own executors,
+    // so they are not inlined here.
     auto next = this->m_bptr;
     const auto eptr = this->m_bptr + this->m_used;
     while(ROCKET_EXPECT(next != eptr)) {
       auto qnode = next;
       next += UINT32_C(1) + qnode->nheaders;
-      AIR_Status status;
-
-      switch(qnode->meta_ver) {
-        case 0:
-          // There is no metadata or symbols.
-          try {
-            status = qnode->pv_exec(ctx, qnode);
-            break;
-          }
-          catch(Runtime_Error& except) {
-            // Forward the exception.
-            throw;
-          }
-          catch(exception& stdex) {
-            // Replace the active exception.
-            Runtime_Error except(Runtime_Error::M_native(), cow_string(stdex.what()));
-            throw except;
-          }
-
-        case 1:
-          // There is metadata without symbols.
-          try {
-            status = qnode->pv_meta->exec(ctx, qnode);
-            break;
-          }
-          catch(Runtime_Error& except) {
-            // Forward the exception.
-            throw;
-          }
-          catch(exception& stdex) {
-            // Replace the active exception.
-            Runtime_Error except(Runtime_Error::M_native(), cow_string(stdex.what()));
-            throw except;
-          }
-
-        default:
-          // There is metadata and symbols.
-          try {
-            status = qnode->pv_meta->exec(ctx, qnode);
-            break;
-          }
-          catch(Runtime_Error& except) {
-            // Modify the exception in place and rethrow it without copying it.
-            except.push_frame_plain(qnode->pv_meta->syms, sref(""));
-            throw;
-          }
-          catch(exception& stdex) {
-            // Replace the active exception.
-            Runtime_Error except(Runtime_Error::M_native(), cow_string(stdex.what()));
-            except.push_frame_plain(qnode->pv_meta->syms, sref(""));
-            throw except;
-          }
-      }
 
-      if(status != air_status_next)
-        return status;
+      if(qnode->meta_ver && qnode->pv_meta->jit_opt)
+        qnode->pv_meta->jit_opt(qnode);
+    }
+
+#ifdef ASTERIA_AVMC_JIT_X86_64_
+    if(this->m_native || (this->m_used == 0))
+      return;
+
+    // Count nodes to get the size of code.
+    size_t ncode = sizeof(s_native_prologue) + this->count_nodes() * s_native_node_size
+                   + sizeof(s_native_epilogue);
+    size_t offset = sizeof(Native_Block) + sizeof(s_native_eh_frame);
+    offset = (offset + 15) / 16 * 16;
+
+    // Allocate a writable block. If this fails, such as when writable pages
+    // are not allowed to become executable, nodes are still interpreted.
+    size_t size = offset + ncode;
+    void* addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                        -1, 0);
+    if(addr == MAP_FAILED)
+      return;
+
+    auto block = static_cast<Native_Block*>(addr);
+    block->size = size;
+    block->code = offset;
+
+    // Write unwind information.
+    auto bcode = static_cast<unsigned char*>(addr) + offset;
+    auto eh_frame = reinterpret_cast<unsigned char*>(block + 1);
+    ::std::memcpy(eh_frame, s_native_eh_frame, sizeof(s_native_eh_frame));
+    do_put_value(eh_frame + s_native_pc_begin_offset, reinterpret_cast<uintptr_t>(bcode));
+    do_put_value(eh_frame + s_native_pc_range_offset, static_cast<uint64_t>(ncode));
+
+    // Write instructions.
+    auto wptr = do_put_bytes(bcode, s_native_prologue, sizeof(s_native_prologue));
+    const auto bexit = bcode + ncode - sizeof(s_native_epilogue) + 2;
+
+    next = this->m_bptr;
+    while(ROCKET_EXPECT(next != eptr)) {
+      auto qnode = next;
+      next += UINT32_C(1) + qnode->nheaders;
+
+      wptr = do_put_bytes(wptr, "\x48\xBE", 2);
+      wptr = do_put_value(wptr, reinterpret_cast<uintptr_t>(qnode));
+      wptr = do_put_bytes(wptr, "\x49\x89\x34\x24\x48\x89\xDF\x48\x8B\x46\x08", 11);
+      if(qnode->meta_ver)
+        wptr = do_put_bytes(wptr, "\x48\x8B\x40\x20", 4);
+      else
+        wptr = do_put_bytes(wptr, "\x0F\x1F\x40\x00", 4);
+      wptr = do_put_bytes(wptr, "\xFF\xD0\x84\xC0\x0F\x85", 6);
+      wptr = do_put_value(wptr, static_cast<int32_t>(bexit - (wptr + 4)));
+    }
+    wptr = do_put_bytes(wptr, s_native_epilogue, sizeof(s_native_epilogue));
+    ROCKET_ASSERT(wptr == bcode + ncode);
+
+    // Make the block executable.
+    if(::mprotect(addr, size, PROT_READ | PROT_EXEC) != 0) {
+      ::munmap(addr, size);
+      return;
+    }
+
+    __register_frame(eh_frame);
+    this->m_native = block;
+#endif
+  }
+
+AIR_Status
+AVMC_Queue::
+execute(Executive_Context& ctx) const
+  {
+    if(this->m_native)
+      return this->do_execute_native(ctx);
+
+    // Exceptions are handled once for the whole queue. If an exception is
+    // thrown, `qnode` will point to the node that has thrown it.
+    const Header* qnode = nullptr;
+    try {
+      auto next = this->m_bptr;
+      const auto eptr = this->m_bptr + this->m_used;
+      while(ROCKET_EXPECT(next != eptr)) {
+        qnode = next;
+        next += UINT32_C(1) + qnode->nheaders;
+
+        auto exec = do_load_executor(qnode);
+        auto status = exec(ctx, qnode);
+        if(status != air_status_next)
+          return status;
+      }
+      return air_status_next;
+    }
+    catch(Runtime_Error& except) {
+      // Modify the exception in place and rethrow it without copying it.
+      this->do_push_symbols_opt(except, qnode);
+      throw;
+    }
+    catch(exception& stdex) {
+      // Replace the active exception.
+      Runtime_Error except(Runtime_Error::M_native(), cow_string(stdex.what()));
+      this->do_push_symbols_opt(except, qnode);
+      throw except;
     }
-    return air_status_next;
   }
 
 void
@@ -12,10 +12,11 @@ namespace asteria {
 class AVMC_Queue
   {
   public:
-    using Uparam      = details_avmc_queue::Uparam;
-    using Header      = details_avmc_queue::Header;
-    using Executor    = details_avmc_queue::Executor;
-    using Var_Getter  = details_avmc_queue::Var_Getter;
+    using Uparam        = details_avmc_queue::Uparam;
+    using Header        = details_avmc_queue::Header;
+    using Executor      = details_avmc_queue::Executor;
+    using Var_Getter    = details_avmc_queue::Var_Getter;
+    using Jit_Compiler  = details_avmc_queue::Jit_Compiler;
 
   private:
     using Metadata     = details_avmc_queue::Metadata;
@@ -23,9 +24,14 @@ class AVMC_Queue
     using Relocator    = details_avmc_queue::Relocator;
     using Destructor   = details_avmc_queue::Destructor;
 
-    Header* m_bptr = nullptr;  // beginning of storage
-    uint32_t m_used = 0;       // used storage in number of `Header`s [!]
-    uint32_t m_estor = 0;      // allocated storage in number of `Header`s [!]
+    Header* m_bptr = nullptr;    // beginning of storage
+    uint32_t m_used = 0;         // used storage in number of `Header`s [!]
+    uint32_t m_estor = 0;        // allocated storage in number of `Header`s [!]
+    void* m_native = nullptr;    // native code generated by `jit_compile()`
+    Metadata* m_mptr = nullptr;  // metadata of all nodes, which are contiguous
+    uint32_t m_mused = 0;        // used metadata in number of `Metadata`s
+    uint32_t m_mestor = 0;       // allocated metadata in number of `Metadata`s
+    cow_string m_files;          // interned file names, separated by null characters
 
   public:
     explicit constexpr
@@ -45,6 +51,11 @@ class AVMC_Queue
         ::std::swap(this->m_bptr, other.m_bptr);
         ::std::swap(this->m_estor, other.m_estor);
         ::std::swap(this->m_used, other.m_used);
+        ::std::swap(this->m_native, other.m_native);
+        ::std::swap(this->m_mptr, other.m_mptr);
+        ::std::swap(this->m_mused, other.m_mused);
+        ::std::swap(this->m_mestor, other.m_mestor);
+        this->m_files.swap(other.m_files);
         return *this;
       }
 
@@ -52,9 +63,23 @@ class AVMC_Queue
     void
     do_destroy_nodes(bool xfree) noexcept;
 
+    void
+    do_free_native() noexcept;
+
     void
     do_reallocate(uint32_t nadd);
 
+    // Reallocate metadata, and update pointers in nodes.
+    void
+    do_reallocate_metadata(uint32_t nadd);
+
+    // Get the offset of `file` in `m_files`, adding it if it's not found.
+    uint32_t
+    do_intern_file(const cow_string& file);
+
+    void
+    do_push_symbols_opt(Runtime_Error& except, const Header* qnode_opt) const;
+
     // Reserve storage for the next node. `size` is the size of `sparam` to initialize.
     inline
     Header*
@@ -71,13 +96,21 @@ class AVMC_Queue
     // `sparam` is filled with zeroes.
     Header*
     do_append_nontrivial(Uparam uparam, Executor* exec, const Source_Location* sloc_opt,
-                         Var_Getter* vget_opt, Relocator* reloc_opt, Destructor* dtor_opt,
-                         size_t size, Constructor* ctor_opt, intptr_t ctor_arg);
+                         Var_Getter* vget_opt, Jit_Compiler* jit_opt, Relocator* reloc_opt,
+                         Destructor* dtor_opt, size_t size, Constructor* ctor_opt,
+                         intptr_t ctor_arg);
+
+    ROCKET_NEVER_INLINE
+    AIR_Status
+    do_execute_native(Executive_Context& ctx) const;
 
   public:
     ~AVMC_Queue()
       {
-        if(this->m_bptr)
+        if(this->m_native)
+          this->do_free_native();
+
+        if(this->m_bptr || this->m_mptr)
           this->do_destroy_nodes(true);
       }
 
@@ -85,14 +118,30 @@ class AVMC_Queue
     empty() const noexcept
       { return this->m_used == 0;  }
 
+    // Get the number of nodes, which is the number of executors that are called
+    // if all nodes are executed. Nodes are stored with variable lengths, so this
+    // function has linear complexity.
+    size_t
+    count_nodes() const noexcept;
+
+    // Get the executor of the node at `index`. This function has linear
+    // complexity.
+    Executor*
+    get_executor(size_t index) const noexcept;
+
     void
     clear() noexcept
       {
+        if(this->m_native)
+          this->do_free_native();
+
         if(this->m_used)
           this->do_destroy_nodes(false);
 
         // Clean invalid data up.
         this->m_used = 0;
+        this->m_mused = 0;
+        this->m_files.clear();
       }
 
     // Append a node. This allows you to bind an arbitrary function.
@@ -105,10 +154,11 @@ class AVMC_Queue
         using Traits = details_avmc_queue::Sparam_traits<Sparam>;
 
         Var_Getter* vget_opt = Traits::vget_opt;
-        if(::std::is_trivial<Sparam>::value && !vget_opt && !sloc_opt)
+        Jit_Compiler* jit_opt = Traits::jit_opt;
+        if(::std::is_trivial<Sparam>::value && !vget_opt && !jit_opt && !sloc_opt)
           return this->do_append_trivial(up, exec, sizeof(sp), ::std::addressof(sp));
 
-        return this->do_append_nontrivial(up, exec, sloc_opt, vget_opt,
+        return this->do_append_nontrivial(up, exec, sloc_opt, vget_opt, jit_opt,
                           Traits::reloc_opt, Traits::dtor_opt, sizeof(sp),
                           details_avmc_queue::do_forward_ctor<XSparamT>,
                           reinterpret_cast<intptr_t>(::std::addressof(sp)));
@@ -121,7 +171,7 @@ class AVMC_Queue
           return this->do_append_trivial(up, exec, 0, nullptr);
 
         return this->do_append_nontrivial(up, exec, sloc_opt,
-                           nullptr, nullptr, nullptr, 0, nullptr, 0);
+                           nullptr, nullptr, nullptr, nullptr, 0, nullptr, 0);
       }
 
     // Mark this queue ready for execution. No nodes may be appended hereafter.
@@ -129,6 +179,23 @@ class AVMC_Queue
     void
     finalize();
 
+    // Translate this queue and all queues nested in it into native code, which
+    // calls executors of nodes directly. This shall be called after `finalize()`.
+    // If the target is not supported, this function does nothing, and nodes are
+    // interpreted as usual.
+    void
+    jit_compile();
+
+    // Replace the executor of a node in place. This can be called by an executor
+    // to specialize its node for operands that it has seen. The new executor
+    // shall accept the same parameters as the old one, and shall produce the
+    // same results for all operands. As a finalized queue may be executed by
+    // multiple threads at the same time, the old one may still be called after
+    // this function returns.
+    static
+    void
+    rewrite_executor(const Header* head, Executor& exec) noexcept;
+
     // These are interfaces called by the runtime.
     AIR_Status
     execute(Executive_Context& ctx) const;
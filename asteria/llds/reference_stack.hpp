@@ -60,6 +60,10 @@ class Reference_Stack
     size() const noexcept
       { return this->m_etop;  }
 
+    size_t
+    capacity() const noexcept
+      { return this->m_estor;  }
+
     void
     clear() noexcept
       {
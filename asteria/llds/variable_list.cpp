@@ -0,0 +1,54 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2022, LH_Mouse. All wrongs reserved.
+
+#include "../precompiled.ipp"
+#include "variable_list.hpp"
+#include "../utils.hpp"
+namespace asteria {
+
+void
+Variable_List::
+do_clear() noexcept
+  {
+    // Detach each variable before releasing it, as destroying its value
+    // may drop other variables.
+    while(this->m_head)
+      this->pop_front_opt();
+  }
+
+void
+Variable_List::
+splice(Variable_List& other) noexcept
+  {
+    ROCKET_ASSERT(this != &other);
+    if(!other.m_head)
+      return;
+
+    // Re-tag all variables. This is unavoidable as membership is recorded
+    // in each variable.
+    auto var = other.m_head;
+    do {
+      var->set_gc_list(this->m_id);
+      var = var->get_gc_next();
+    }
+    while(var != other.m_head);
+
+    auto head = ::std::exchange(other.m_head, nullptr);
+    size_t size = ::std::exchange(other.m_size, (size_t) 0);
+    this->m_size += size;
+
+    if(!this->m_head) {
+      this->m_head = head;
+      return;
+    }
+
+    // Join both circular lists.
+    auto last = this->m_head->get_gc_prev();
+    auto other_last = head->get_gc_prev();
+    last->set_gc_next(head);
+    head->set_gc_prev(last);
+    other_last->set_gc_next(this->m_head);
+    this->m_head->set_gc_prev(other_last);
+  }
+
+}  // namespace asteria
@@ -0,0 +1,156 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2022, LH_Mouse. All wrongs reserved.
+
+#ifndef ASTERIA_LLDS_VARIABLE_LIST_
+#define ASTERIA_LLDS_VARIABLE_LIST_
+
+#include "../fwd.hpp"
+#include "../runtime/variable.hpp"
+namespace asteria {
+
+// This is an intrusive list of variables, linked through their GC links.
+// Each variable in a list is owned by it, and is tagged with the ID of
+// that list, so membership can be tested without a lookup. A variable
+// may belong to at most one list at a time.
+class Variable_List
+  {
+  private:
+    Variable* m_head = nullptr;  // the first variable; its `prev` is the last
+    size_t m_size = 0;           // number of variables
+    uint8_t m_id;                // ID of this list, which shall be non-zero
+
+  public:
+    explicit constexpr
+    Variable_List(uint8_t id) noexcept
+      : m_id(id)
+      { }
+
+    Variable_List(const Variable_List&) = delete;
+    Variable_List& operator=(const Variable_List&) = delete;
+
+  private:
+    void
+    do_attach(Variable* var) noexcept
+      {
+        // Insert the variable after the last one, which is circular.
+        ROCKET_ASSERT(var->get_gc_list() == 0);
+        var->set_gc_list(this->m_id);
+
+        auto head = this->m_head;
+        if(!head) {
+          var->set_gc_prev(var);
+          var->set_gc_next(var);
+          this->m_head = var;
+        }
+        else {
+          auto last = head->get_gc_prev();
+          var->set_gc_prev(last);
+          var->set_gc_next(head);
+          last->set_gc_next(var);
+          head->set_gc_prev(var);
+        }
+        this->m_size ++;
+      }
+
+    void
+    do_detach(Variable* var) noexcept
+      {
+        ROCKET_ASSERT(var->get_gc_list() == this->m_id);
+        var->set_gc_list(0);
+
+        auto next = var->get_gc_next();
+        if(next == var) {
+          this->m_head = nullptr;
+        }
+        else {
+          auto prev = var->get_gc_prev();
+          prev->set_gc_next(next);
+          next->set_gc_prev(prev);
+
+          if(this->m_head == var)
+            this->m_head = next;
+        }
+        this->m_size --;
+      }
+
+    void
+    do_clear() noexcept;
+
+  public:
+    ~Variable_List()
+      {
+        if(this->m_head)
+          this->do_clear();
+      }
+
+    uint8_t
+    id() const noexcept
+      { return this->m_id;  }
+
+    bool
+    empty() const noexcept
+      { return this->m_head == nullptr;  }
+
+    size_t
+    size() const noexcept
+      { return this->m_size;  }
+
+    bool
+    contains(const Variable* var) const noexcept
+      { return var->get_gc_list() == this->m_id;  }
+
+    Variable*
+    front_opt() const noexcept
+      { return this->m_head;  }
+
+    void
+    clear() noexcept
+      {
+        if(this->m_head)
+          this->do_clear();
+      }
+
+    // Adds a variable to the end of this list, which takes a reference.
+    void
+    push_back(const refcnt_ptr<Variable>& var) noexcept
+      {
+        this->do_attach(var.get());
+        var->add_reference();
+      }
+
+    // Removes a variable from this list, and returns the reference
+    // that was owned by it.
+    refcnt_ptr<Variable>
+    erase(Variable* var) noexcept
+      {
+        this->do_detach(var);
+        return refcnt_ptr<Variable>(var);
+      }
+
+    refcnt_ptr<Variable>
+    pop_front_opt() noexcept
+      {
+        auto var = this->m_head;
+        if(!var)
+          return nullptr;
+
+        this->do_detach(var);
+        return refcnt_ptr<Variable>(var);
+      }
+
+    // Moves a variable from `other` to the end of this list. No reference
+    // counter is modified.
+    void
+    transfer(Variable_List& other, Variable* var) noexcept
+      {
+        other.do_detach(var);
+        this->do_attach(var);
+      }
+
+    // Moves all variables from `other` to the end of this list.
+    void
+    splice(Variable_List& other) noexcept;
+  };
+
+}  // namespace asteria
+#endif
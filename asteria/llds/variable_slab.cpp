@@ -0,0 +1,183 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2022, LH_Mouse. All wrongs reserved.
+
+#include "../precompiled.ipp"
+#include "variable_slab.hpp"
+#include "../utils.hpp"
+namespace asteria {
+namespace {
+
+using details_variable_slab::Slot;
+using details_variable_slab::Chunk;
+
+// Chunks are aligned to cache lines. Slots follow the header.
+constexpr size_t chunk_align = 64;
+constexpr size_t chunk_size = 16384;
+constexpr size_t chunk_header_size = (sizeof(Chunk) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+constexpr size_t chunk_nslots = (chunk_size - chunk_header_size) / sizeof(Slot);
+
+Slot*
+do_get_slot(Chunk* chunk, size_t index) noexcept
+  {
+    auto base = reinterpret_cast<char*>(chunk) + chunk_header_size;
+    return reinterpret_cast<Slot*>(base) + index;
+  }
+
+Slot*
+do_slot_from_storage(void* ptr) noexcept
+  {
+    return reinterpret_cast<Slot*>(static_cast<char*>(ptr) - offsetof(Slot, stor));
+  }
+
+void
+do_free_chunk(Chunk* chunk) noexcept
+  {
+    ROCKET_ASSERT(chunk->nlive == 0);
+    ::operator delete(chunk, ::std::align_val_t(chunk_align));
+  }
+
+}  // namespace
+
+Variable_Slab::
+~Variable_Slab()
+  {
+    // Free chunks that are not in use. The others are released when their
+    // last variables are freed.
+    while(auto chunk = this->m_head) {
+      this->do_list_detach(chunk);
+      chunk->owner = nullptr;
+
+      if(chunk->nlive == 0)
+        do_free_chunk(chunk);
+    }
+  }
+
+void
+Variable_Slab::
+do_list_attach_front(Chunk* chunk) noexcept
+  {
+    chunk->prev = nullptr;
+    chunk->next = this->m_head;
+    (this->m_head ? this->m_head->prev : this->m_tail) = chunk;
+    this->m_head = chunk;
+  }
+
+void
+Variable_Slab::
+do_list_attach_back(Chunk* chunk) noexcept
+  {
+    chunk->prev = this->m_tail;
+    chunk->next = nullptr;
+    (this->m_tail ? this->m_tail->next : this->m_head) = chunk;
+    this->m_tail = chunk;
+  }
+
+void
+Variable_Slab::
+do_list_detach(Chunk* chunk) noexcept
+  {
+    (chunk->prev ? chunk->prev->next : this->m_head) = chunk->next;
+    (chunk->next ? chunk->next->prev : this->m_tail) = chunk->prev;
+  }
+
+void
+Variable_Slab::
+do_free_slot(Slot* slot) noexcept
+  {
+    auto chunk = slot->chunk;
+    bool was_full = chunk->free == nullptr;
+    slot->next = chunk->free;
+    chunk->free = slot;
+    chunk->nlive --;
+
+    if(chunk->nlive == 0) {
+      // Keep one empty chunk for reuse, and free the others.
+      if(!this->m_spare || (this->m_spare == chunk)) {
+        this->m_spare = chunk;
+      }
+      else {
+        this->do_list_detach(chunk);
+        this->m_nchunks --;
+        do_free_chunk(chunk);
+        return;
+      }
+    }
+
+    // Move chunks with free slots to the front.
+    if(was_full) {
+      this->do_list_detach(chunk);
+      this->do_list_attach_front(chunk);
+    }
+  }
+
+void*
+Variable_Slab::
+allocate()
+  {
+    auto chunk = this->m_head;
+    if(!chunk || !chunk->free) {
+      // All chunks are full, so allocate a new one.
+      chunk = static_cast<Chunk*>(::operator new(chunk_size, ::std::align_val_t(chunk_align)));
+      chunk->owner = this;
+      chunk->free = nullptr;
+      chunk->nlive = 0;
+
+      for(size_t k = chunk_nslots;  k != 0;  --k) {
+        auto slot = do_get_slot(chunk, k - 1);
+        slot->chunk = chunk;
+        slot->next = chunk->free;
+        chunk->free = slot;
+      }
+
+      this->do_list_attach_front(chunk);
+      this->m_nchunks ++;
+    }
+
+    // Take a free slot.
+    auto slot = chunk->free;
+    chunk->free = slot->next;
+    chunk->nlive ++;
+
+    if(chunk == this->m_spare)
+      this->m_spare = nullptr;
+
+    // If this chunk is now full, move it to the back.
+    if(!chunk->free && chunk->next && chunk->next->free) {
+      this->do_list_detach(chunk);
+      this->do_list_attach_back(chunk);
+    }
+
+    return slot->stor;
+  }
+
+void*
+Variable_Slab::
+allocate_unowned()
+  {
+    auto slot = static_cast<Slot*>(::operator new(sizeof(Slot)));
+    slot->chunk = nullptr;
+    return slot->stor;
+  }
+
+void
+Variable_Slab::
+deallocate(void* ptr) noexcept
+  {
+    if(!ptr)
+      return;
+
+    auto slot = do_slot_from_storage(ptr);
+    auto chunk = slot->chunk;
+    if(!chunk)
+      return ::operator delete(slot);
+
+    if(chunk->owner)
+      return chunk->owner->do_free_slot(slot);
+
+    // The slab has been destroyed, so free the chunk with its last slot.
+    chunk->nlive --;
+    if(chunk->nlive == 0)
+      do_free_chunk(chunk);
+  }
+
+}  // namespace asteria
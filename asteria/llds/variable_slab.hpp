@@ -0,0 +1,75 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2022, LH_Mouse. All wrongs reserved.
+
+#ifndef ASTERIA_LLDS_VARIABLE_SLAB_
+#define ASTERIA_LLDS_VARIABLE_SLAB_
+
+#include "../fwd.hpp"
+#include "../runtime/variable.hpp"
+#include "../details/variable_slab.ipp"
+namespace asteria {
+
+// This allocates storage for variables from aligned chunks, which are
+// recycled through free lists. Each slot records its chunk, so storage can
+// be freed without knowing its slab. If a slab is destroyed while some of
+// its variables are still alive, their chunks are released with the last
+// of them.
+class Variable_Slab
+  {
+  private:
+    using Chunk = details_variable_slab::Chunk;
+
+    Chunk* m_head = nullptr;   // chunks with free slots come first
+    Chunk* m_tail = nullptr;
+    Chunk* m_spare = nullptr;  // an empty chunk that is kept for reuse
+    size_t m_nchunks = 0;
+
+  public:
+    explicit constexpr
+    Variable_Slab() noexcept
+      { }
+
+    Variable_Slab(const Variable_Slab&) = delete;
+    Variable_Slab& operator=(const Variable_Slab&) = delete;
+
+  private:
+    inline
+    void
+    do_list_attach_front(Chunk* chunk) noexcept;
+
+    inline
+    void
+    do_list_attach_back(Chunk* chunk) noexcept;
+
+    inline
+    void
+    do_list_detach(Chunk* chunk) noexcept;
+
+    inline
+    void
+    do_free_slot(details_variable_slab::Slot* slot) noexcept;
+
+  public:
+    ~Variable_Slab();
+
+    size_t
+    count_chunks() const noexcept
+      { return this->m_nchunks;  }
+
+    // Allocates storage for a variable from this slab.
+    void*
+    allocate();
+
+    // Allocates storage for a variable that does not belong to any slab.
+    static
+    void*
+    allocate_unowned();
+
+    // Frees storage that has been allocated by either function above.
+    static
+    void
+    deallocate(void* ptr) noexcept;
+  };
+
+}  // namespace asteria
+#endif
@@ -15,6 +15,7 @@ class Abstract_Context
     struct M_plain     { };
     struct M_defer     { };
     struct M_function  { };
+    struct M_capture   { };
 
   private:
     // This stores all named references (variables, parameters, etc.) of
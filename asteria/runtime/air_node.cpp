@@ -14,7 +14,9 @@
 #include "variable.hpp"
 #include "ptc_arguments.hpp"
 #include "module_loader.hpp"
+#include "call_pool.hpp"
 #include "air_optimizer.hpp"
+#include "instantiated_function.hpp"
 #include "../compiler/token_stream.hpp"
 #include "../compiler/statement_sequence.hpp"
 #include "../compiler/statement.hpp"
@@ -66,7 +68,7 @@ bool
 do_solidify_nodes(AVMC_Queue& queue, const cow_vector<AIR_Node>& code)
   {
     queue.clear();
-    bool r = ::rocket::all_of(code, [&](const AIR_Node& node) { return node.solidify(queue);  });
+    bool r = AIR_Node::solidify_all(queue, code);
     queue.finalize();
     return r;
   }
@@ -79,6 +81,13 @@ do_solidify_nodes(cow_vector<AVMC_Queue>& queue, const cow_vector<cow_vector<AIR
       do_solidify_nodes(queue.mut(k), code.at(k));
   }
 
+bool
+do_is_terminated(const cow_vector<AIR_Node>& code) noexcept
+  {
+    // A sequence terminates control flow if any node in it does.
+    return ::rocket::any_of(code, [&](const AIR_Node& node) { return node.is_terminator();  });
+  }
+
 AIR_Status
 do_evaluate_subexpression(Executive_Context& ctx, bool assign, const AVMC_Queue& queue)
   {
@@ -129,6 +138,49 @@ do_execute_block(const AVMC_Queue& queue, Executive_Context& ctx)
     return status;
   }
 
+const cow_vector<AIR_Node>*
+do_get_scoped_body_opt(const cow_vector<AIR_Node>& code) noexcept
+  {
+    // A loop body that needs a context of its own has been marked with a
+    // single block node. Otherwise it is executed in the enclosing context.
+    if(code.size() != 1)
+      return nullptr;
+
+    auto qblock = code[0].get_opt<AIR_Node::S_execute_block>();
+    return qblock ? &(qblock->code_body) : nullptr;
+  }
+
+AIR_Status
+do_execute_loop_body(const AVMC_Queue& queue, Executive_Context& ctx, opt<Executive_Context>& ctx_body)
+  {
+    // If the body is scope-free, there is no context for it, so execute it in
+    // the enclosing context.
+    if(!ctx_body)
+      return queue.execute(ctx);
+
+    // Execute the body on `ctx_body`, which is reused by all iterations.
+    AIR_Status status;
+
+    try {
+      status = queue.execute(*ctx_body);
+    }
+    catch(Runtime_Error& except) {
+      ctx_body->on_scope_exit(except);
+      throw;
+    }
+    ctx_body->on_scope_exit(status);
+    ctx_body->reset();
+    return status;
+  }
+
+void
+do_prepare_loop_body(opt<Executive_Context>& ctx_body, bool scoped, Executive_Context& ctx)
+  {
+    // Create a context for the body only if it declares something.
+    if(scoped)
+      ctx_body.emplace(Executive_Context::M_plain(), ctx);
+  }
+
 Reference&
 do_push_reference_common(Reference_Stack& stack, const Reference& ref)
   {
@@ -151,11 +203,6 @@ struct Sparam_sloc_name
     phsh_string name;
   };
 
-struct Sparam_name
-  {
-    phsh_string name;
-  };
-
 struct Sparam_import
   {
     Compiler_Options opts;
@@ -172,6 +219,21 @@ do_for_each_get_variables(ContainerT& cont, Variable_HashMap& staged,
       r.get_variables(staged, temp);
   }
 
+template<typename ContainerT>
+void
+do_for_each_jit_compile(ContainerT& cont)
+  {
+    for(auto& queue : cont)
+      queue.jit_compile();
+  }
+
+void
+do_for_each_jit_compile(cow_vector<AVMC_Queue>& queues)
+  {
+    for(size_t k = 0;  k != queues.size();  ++k)
+      queues.mut(k).jit_compile();
+  }
+
 template<size_t N>
 struct Sparam_queues
   {
@@ -182,6 +244,12 @@ struct Sparam_queues
       {
         do_for_each_get_variables(this->queues, staged, temp);
       }
+
+    void
+    jit_compile()
+      {
+        do_for_each_jit_compile(this->queues);
+      }
   };
 
 using Sparam_queues_2 = Sparam_queues<2>;
@@ -192,7 +260,6 @@ struct Sparam_switch
   {
     cow_vector<AVMC_Queue> queues_labels;
     cow_vector<AVMC_Queue> queues_bodies;
-    cow_vector<cow_vector<phsh_string>> names_added;
 
     void
     get_variables(Variable_HashMap& staged, Variable_HashMap& temp) const
@@ -200,12 +267,19 @@ struct Sparam_switch
         do_for_each_get_variables(this->queues_labels, staged, temp);
         do_for_each_get_variables(this->queues_bodies, staged, temp);
       }
+
+    void
+    jit_compile()
+      {
+        do_for_each_jit_compile(this->queues_labels);
+        do_for_each_jit_compile(this->queues_bodies);
+      }
   };
 
 struct Sparam_for_each
   {
-    phsh_string name_key;
-    phsh_string name_mapped;
+    uint32_t slot_key;
+    uint32_t slot_mapped;
     AVMC_Queue queue_init;
     AVMC_Queue queue_body;
 
@@ -215,6 +289,13 @@ struct Sparam_for_each
         this->queue_init.get_variables(staged, temp);
         this->queue_body.get_variables(staged, temp);
       }
+
+    void
+    jit_compile()
+      {
+        this->queue_init.jit_compile();
+        this->queue_body.jit_compile();
+      }
   };
 
 struct Sparam_try_catch
@@ -222,8 +303,9 @@ struct Sparam_try_catch
     Source_Location sloc_try;
     AVMC_Queue queue_try;
     Source_Location sloc_catch;
-    phsh_string name_except;
+    uint32_t slot_except;
     AVMC_Queue queue_catch;
+    bool backtrace;
 
     void
     get_variables(Variable_HashMap& staged, Variable_HashMap& temp) const
@@ -231,6 +313,13 @@ struct Sparam_try_catch
         this->queue_try.get_variables(staged, temp);
         this->queue_catch.get_variables(staged, temp);
       }
+
+    void
+    jit_compile()
+      {
+        this->queue_try.jit_compile();
+        this->queue_catch.jit_compile();
+      }
   };
 
 struct Sparam_func
@@ -240,11 +329,16 @@ struct Sparam_func
     cow_string func;
     cow_vector<phsh_string> params;
     cow_vector<AIR_Node> code_body;
+    refcnt_ptr<const Instantiated_Function> proto;
+    cow_vector<AIR_Node::S_push_local_reference> captures;
 
     void
     get_variables(Variable_HashMap& staged, Variable_HashMap& temp) const
       {
         do_for_each_get_variables(this->code_body, staged, temp);
+
+        if(this->proto)
+          this->proto->get_variables(staged, temp);
       }
   };
 
@@ -260,6 +354,37 @@ struct Sparam_defer
       }
   };
 
+struct Sparam_local_member
+  {
+    phsh_string name;
+    phsh_string memb;
+  };
+
+struct Sparam_local_temp_xop
+  {
+    phsh_string name;
+    Value value;
+    bool assign;
+
+    void
+    get_variables(Variable_HashMap& staged, Variable_HashMap& temp) const
+      {
+        this->value.get_variables(staged, temp);
+      }
+  };
+
+struct Sparam_temp_call
+  {
+    Source_Location sloc;
+    Value value;
+
+    void
+    get_variables(Variable_HashMap& staged, Variable_HashMap& temp) const
+      {
+        this->value.get_variables(staged, temp);
+      }
+  };
+
 // These are traits for individual AIR node types.
 // Each traits struct must contain the `execute()` function, and optionally,
 // these functions: `make_uparam()`, `make_sparam()`, `get_symbols()`.
@@ -302,7 +427,7 @@ struct Traits_execute_block
 
 struct Traits_declare_variable
   {
-    // `up` is unused.
+    // `up` is `untracked` and the frame slot.
     // `sp` is the source location and name;
 
     static
@@ -312,6 +437,16 @@ struct Traits_declare_variable
         return altr.sloc;
       }
 
+    static
+    AVMC_Queue::Uparam
+    make_uparam(bool& /*reachable*/, const AIR_Node::S_declare_variable& altr)
+      {
+        AVMC_Queue::Uparam up;
+        up.u8v[0] = altr.untracked;
+        up.u32 = altr.slot;
+        return up;
+      }
+
     static
     Sparam_sloc_name
     make_sparam(bool& /*reachable*/, const AIR_Node::S_declare_variable& altr)
@@ -324,15 +459,17 @@ struct Traits_declare_variable
 
     ROCKET_FLATTEN static
     AIR_Status
-    execute(Executive_Context& ctx, const Sparam_sloc_name& sp)
+    execute(Executive_Context& ctx, AVMC_Queue::Uparam up, const Sparam_sloc_name& sp)
       {
         const auto qhooks = ctx.global().get_hooks_opt();
         const auto gcoll = ctx.global().garbage_collector();
 
-        // Allocate an uninitialized variable.
+        // Allocate an uninitialized variable. If it never escapes, it need
+        // not be tracked by the garbage collector.
         // Inject the variable into the current context.
-        const auto var = gcoll->create_variable();
-        ctx.mut_named_reference(sp.name).set_variable(var);
+        const auto var = up.u8v[0] ? gcoll->create_untracked_variable()
+                                   : gcoll->create_variable();
+        ctx.mut_local_slot(up.u32).set_variable(var);
         if(qhooks)
           qhooks->on_variable_declare(sp.sloc, sp.name);
 
@@ -416,10 +553,10 @@ struct Traits_if_statement
         // Check the value of the condition.
         if(ctx.stack().top().dereference_readonly().test() != up.u8v[0])
           // Execute the true branch and forward the status verbatim.
-          return do_execute_block(sp.queues[0], ctx);
+          return sp.queues[0].execute(ctx);
 
         // Execute the false branch and forward the status verbatim.
-        return do_execute_block(sp.queues[1], ctx);
+        return sp.queues[1].execute(ctx);
       }
   };
 
@@ -435,7 +572,6 @@ struct Traits_switch_statement
         Sparam_switch sp;
         do_solidify_nodes(sp.queues_labels, altr.code_labels);
         do_solidify_nodes(sp.queues_bodies, altr.code_bodies);
-        sp.names_added = altr.names_added;
         return sp;
       }
 
@@ -446,7 +582,6 @@ struct Traits_switch_statement
         // Get the number of clauses.
         auto nclauses = sp.queues_labels.size();
         ROCKET_ASSERT(nclauses == sp.queues_bodies.size());
-        ROCKET_ASSERT(nclauses == sp.names_added.size());
 
         // Read the value of the condition and find the target clause for it.
         auto cond = ctx.stack().top().dereference_readonly();
@@ -480,10 +615,6 @@ struct Traits_switch_statement
           Executive_Context ctx_body(Executive_Context::M_plain(), ctx);
           AIR_Status status;
 
-          // Inject all bypassed variables into the scope.
-          for(const auto& name : sp.names_added[bp])
-            ctx_body.mut_named_reference(name).set_invalid();
-
           try {
             do {
               // Execute the body.
@@ -509,7 +640,7 @@ struct Traits_switch_statement
 
 struct Traits_do_while_statement
   {
-    // `up` is `negative`.
+    // `up` is `negative` and whether the body is scoped.
     // `sp` is the loop body and condition.
 
     static
@@ -518,6 +649,7 @@ struct Traits_do_while_statement
       {
         AVMC_Queue::Uparam up;
         up.u8v[0] = altr.negative;
+        up.u8v[1] = !!do_get_scoped_body_opt(altr.code_body);
         return up;
       }
 
@@ -526,7 +658,8 @@ struct Traits_do_while_statement
     make_sparam(bool& reachable, const AIR_Node::S_do_while_statement& altr)
       {
         Sparam_queues_2 sp;
-        reachable &= do_solidify_nodes(sp.queues[0], altr.code_body);
+        auto qbody = do_get_scoped_body_opt(altr.code_body);
+        reachable &= do_solidify_nodes(sp.queues[0], qbody ? *qbody : altr.code_body);
         do_solidify_nodes(sp.queues[1], altr.code_cond);
         return sp;
       }
@@ -536,9 +669,11 @@ struct Traits_do_while_statement
     execute(Executive_Context& ctx, AVMC_Queue::Uparam up, const Sparam_queues_2& sp)
       {
         // This is the same as the `do...while` statement in C.
+        opt<Executive_Context> ctx_body;
+        do_prepare_loop_body(ctx_body, up.u8v[1], ctx);
         for(;;) {
           // Execute the body.
-          auto status = do_execute_block(sp.queues[0], ctx);
+          auto status = do_execute_loop_body(sp.queues[0], ctx, ctx_body);
           if(::rocket::is_any_of(status,
                 { air_status_break_unspec, air_status_break_while }))
             break;
@@ -559,7 +694,7 @@ struct Traits_do_while_statement
 
 struct Traits_while_statement
   {
-    // `up` is `negative`.
+    // `up` is `negative` and whether the body is scoped.
     // `sp` is the condition and loop body.
 
     static
@@ -568,6 +703,7 @@ struct Traits_while_statement
       {
         AVMC_Queue::Uparam up;
         up.u8v[0] = altr.negative;
+        up.u8v[1] = !!do_get_scoped_body_opt(altr.code_body);
         return up;
       }
 
@@ -576,8 +712,9 @@ struct Traits_while_statement
     make_sparam(bool& /*reachable*/, const AIR_Node::S_while_statement& altr)
       {
         Sparam_queues_2 sp;
+        auto qbody = do_get_scoped_body_opt(altr.code_body);
         do_solidify_nodes(sp.queues[0], altr.code_cond);
-        do_solidify_nodes(sp.queues[1], altr.code_body);
+        do_solidify_nodes(sp.queues[1], qbody ? *qbody : altr.code_body);
         return sp;
       }
 
@@ -586,6 +723,8 @@ struct Traits_while_statement
     execute(Executive_Context& ctx, AVMC_Queue::Uparam up, const Sparam_queues_2& sp)
       {
         // This is the same as the `while` statement in C.
+        opt<Executive_Context> ctx_body;
+        do_prepare_loop_body(ctx_body, up.u8v[1], ctx);
         for(;;) {
           // Check the condition.
           auto status = sp.queues[0].execute(ctx);
@@ -594,7 +733,7 @@ struct Traits_while_statement
             break;
 
           // Execute the body.
-          status = do_execute_block(sp.queues[1], ctx);
+          status = do_execute_loop_body(sp.queues[1], ctx, ctx_body);
           if(::rocket::is_any_of(status,
                 { air_status_break_unspec, air_status_break_while }))
             break;
@@ -609,24 +748,34 @@ struct Traits_while_statement
 
 struct Traits_for_each_statement
   {
-    // `up` is unused.
+    // `up` is whether the body is scoped.
     // `sp` is ... everything.
 
+    static
+    AVMC_Queue::Uparam
+    make_uparam(bool& /*reachable*/, const AIR_Node::S_for_each_statement& altr)
+      {
+        AVMC_Queue::Uparam up;
+        up.u8v[0] = !!do_get_scoped_body_opt(altr.code_body);
+        return up;
+      }
+
     static
     Sparam_for_each
     make_sparam(bool& /*reachable*/, const AIR_Node::S_for_each_statement& altr)
       {
         Sparam_for_each sp;
-        sp.name_key = altr.name_key;
-        sp.name_mapped = altr.name_mapped;
+        sp.slot_key = altr.slot_key;
+        sp.slot_mapped = altr.slot_mapped;
+        auto qbody = do_get_scoped_body_opt(altr.code_body);
         do_solidify_nodes(sp.queue_init, altr.code_init);
-        do_solidify_nodes(sp.queue_body, altr.code_body);
+        do_solidify_nodes(sp.queue_body, qbody ? *qbody : altr.code_body);
         return sp;
       }
 
     ROCKET_FLATTEN static
     AIR_Status
-    execute(Executive_Context& ctx, const Sparam_for_each& sp)
+    execute(Executive_Context& ctx, AVMC_Queue::Uparam up, const Sparam_for_each& sp)
       {
         // Get global interfaces.
         auto gcoll = ctx.global().garbage_collector();
@@ -637,18 +786,18 @@ struct Traits_for_each_statement
 
         // Allocate an uninitialized variable for the key.
         const auto vkey = gcoll->create_variable();
-        ctx_for.mut_named_reference(sp.name_key).set_variable(vkey);
-
-        // Create the mapped reference.
-        auto& mapped = ctx_for.mut_named_reference(sp.name_mapped);
+        ctx_for.mut_local_slot(sp.slot_key).set_variable(vkey);
 
         // Evaluate the range initializer and set the range up, which isn't going to
-        // change for all loops.
+        // change for all loops. The mapped reference is looked up by slot whenever
+        // it is used, as the body may reallocate slots of `ctx_for`.
         auto status = sp.queue_init.execute(ctx_for);
         ROCKET_ASSERT(status == air_status_next);
-        mapped = ::std::move(ctx_for.stack().mut_top());
+        ctx_for.mut_local_slot(sp.slot_mapped) = ::std::move(ctx_for.stack().mut_top());
+        opt<Executive_Context> ctx_body;
+        do_prepare_loop_body(ctx_body, up.u8v[0], ctx_for);
 
-        const auto range = mapped.dereference_readonly();
+        const auto range = ctx_for.mut_local_slot(sp.slot_mapped).dereference_readonly();
         switch(weaken_enum(range.type())) {
           case type_null:
             // Do nothing.
@@ -659,11 +808,12 @@ struct Traits_for_each_statement
             for(int64_t i = 0;  i < arr.ssize();  ++i) {
               // Set the key which is the subscript of the mapped element in the array.
               vkey->initialize(i, Variable::state_immutable);
+              auto& mapped = ctx_for.mut_local_slot(sp.slot_mapped);
               mapped.push_modifier_array_index(i);
               mapped.dereference_readonly();
 
               // Execute the loop body.
-              status = do_execute_block(sp.queue_body, ctx_for);
+              status = do_execute_loop_body(sp.queue_body, ctx_for, ctx_body);
               if(::rocket::is_any_of(status, { air_status_break_unspec,
                                  air_status_break_for }))
                 break;
@@ -673,7 +823,7 @@ struct Traits_for_each_statement
                 return status;
 
               // Restore the mapped reference.
-              mapped.pop_modifier();
+              ctx_for.mut_local_slot(sp.slot_mapped).pop_modifier();
             }
             return air_status_next;
           }
@@ -683,11 +833,12 @@ struct Traits_for_each_statement
             for(auto it = obj.begin();  it != obj.end();  ++it) {
               // Set the key which is the key of this element in the object.
               vkey->initialize(it->first.rdstr(), Variable::state_immutable);
+              auto& mapped = ctx_for.mut_local_slot(sp.slot_mapped);
               mapped.push_modifier_object_key(it->first);
               mapped.dereference_readonly();
 
               // Execute the loop body.
-              status = do_execute_block(sp.queue_body, ctx_for);
+              status = do_execute_loop_body(sp.queue_body, ctx_for, ctx_body);
               if(::rocket::is_any_of(status, { air_status_break_unspec,
                                  air_status_break_for }))
                 break;
@@ -697,7 +848,7 @@ struct Traits_for_each_statement
                 return status;
 
               // Restore the mapped reference.
-              mapped.pop_modifier();
+              ctx_for.mut_local_slot(sp.slot_mapped).pop_modifier();
             }
             return air_status_next;
           }
@@ -712,24 +863,34 @@ struct Traits_for_each_statement
 
 struct Traits_for_statement
   {
-    // `up` is unused.
+    // `up` is whether the body is scoped.
     // `sp` is ... everything.
 
+    static
+    AVMC_Queue::Uparam
+    make_uparam(bool& /*reachable*/, const AIR_Node::S_for_statement& altr)
+      {
+        AVMC_Queue::Uparam up;
+        up.u8v[0] = !!do_get_scoped_body_opt(altr.code_body);
+        return up;
+      }
+
     static
     Sparam_queues_4
     make_sparam(bool& /*reachable*/, const AIR_Node::S_for_statement& altr)
       {
         Sparam_queues_4 sp;
+        auto qbody = do_get_scoped_body_opt(altr.code_body);
         do_solidify_nodes(sp.queues[0], altr.code_init);
         do_solidify_nodes(sp.queues[1], altr.code_cond);
         do_solidify_nodes(sp.queues[2], altr.code_step);
-        do_solidify_nodes(sp.queues[3], altr.code_body);
+        do_solidify_nodes(sp.queues[3], qbody ? *qbody : altr.code_body);
         return sp;
       }
 
     ROCKET_FLATTEN static
     AIR_Status
-    execute(Executive_Context& ctx, const Sparam_queues_4& sp)
+    execute(Executive_Context& ctx, AVMC_Queue::Uparam up, const Sparam_queues_4& sp)
       {
         // This is the same as the `for` statement in C.
         // We have to create an outer context due to the fact that names declared in the
@@ -740,6 +901,8 @@ struct Traits_for_statement
         // statement.
         auto status = sp.queues[0].execute(ctx_for);
         ROCKET_ASSERT(status == air_status_next);
+        opt<Executive_Context> ctx_body;
+        do_prepare_loop_body(ctx_body, up.u8v[0], ctx_for);
         for(;;) {
           // Check the condition.
           status = sp.queues[1].execute(ctx_for);
@@ -751,7 +914,7 @@ struct Traits_for_statement
             break;
 
           // Execute the body.
-          status = do_execute_block(sp.queues[3], ctx_for);
+          status = do_execute_loop_body(sp.queues[3], ctx_for, ctx_body);
           if(::rocket::is_any_of(status,
                 { air_status_break_unspec, air_status_break_for }))
             break;
@@ -781,8 +944,9 @@ struct Traits_try_statement
         sp.sloc_try = altr.sloc_try;
         bool rtry = do_solidify_nodes(sp.queue_try, altr.code_try);
         sp.sloc_catch = altr.sloc_catch;
-        sp.name_except = altr.name_except;
+        sp.slot_except = altr.slot_except;
         bool rcatch = do_solidify_nodes(sp.queue_catch, altr.code_catch);
+        sp.backtrace = altr.backtrace;
         reachable &= rtry | rcatch;
         return sp;
       }
@@ -794,7 +958,7 @@ struct Traits_try_statement
         // This is almost identical to JavaScript.
         // Execute the `try` block. If no exception is thrown, this will have
         // little overhead.
-        auto status = do_execute_block(sp.queue_try, ctx);
+        auto status = sp.queue_try.execute(ctx);
         if(status != air_status_return_ref)
           return status;
 
@@ -816,27 +980,30 @@ struct Traits_try_statement
 
         try {
           // Set the exception reference.
-          ctx_catch.mut_named_reference(sp.name_except)
+          ctx_catch.mut_local_slot(sp.slot_except)
               .set_temporary(except.value());
 
-          // Set backtrace frames.
-          V_array backtrace;
-          for(size_t i = 0;  i < except.count_frames();  ++i) {
-            const auto& f = except.frame(i);
-
-            // Translate each frame into a human-readable format.
-            V_object r;
-            r.try_emplace(sref("frame"), sref(f.what_type()));
-            r.try_emplace(sref("file"), f.file());
-            r.try_emplace(sref("line"), f.line());
-            r.try_emplace(sref("column"), f.column());
-            r.try_emplace(sref("value"), f.value());
-
-            // Append this frame.
-            backtrace.emplace_back(::std::move(r));
+          // Set backtrace frames. This is skipped if the optimizer has
+          // proven that `__backtrace` is never referenced.
+          if(sp.backtrace) {
+            V_array backtrace;
+            for(size_t i = 0;  i < except.count_frames();  ++i) {
+              const auto& f = except.frame(i);
+
+              // Translate each frame into a human-readable format.
+              V_object r;
+              r.try_emplace(sref("frame"), sref(f.what_type()));
+              r.try_emplace(sref("file"), f.file());
+              r.try_emplace(sref("line"), f.line());
+              r.try_emplace(sref("column"), f.column());
+              r.try_emplace(sref("value"), f.value());
+
+              // Append this frame.
+              backtrace.emplace_back(::std::move(r));
+            }
+            ctx_catch.mut_named_reference(sref("__backtrace"))
+                .set_temporary(::std::move(backtrace));
           }
-          ctx_catch.mut_named_reference(sref("__backtrace"))
-              .set_temporary(::std::move(backtrace));
 
           // Execute the `catch` clause.
           status = sp.queue_catch.execute(ctx_catch);
@@ -1009,7 +1176,7 @@ struct Traits_push_global_reference
 
 struct Traits_push_local_reference
   {
-    // `up` is the depth and hint.
+    // `up` is the depth and frame slot.
     // `sp` is the source location and name;
 
     static
@@ -1023,9 +1190,14 @@ struct Traits_push_local_reference
     AVMC_Queue::Uparam
     make_uparam(bool& /*reachable*/, const AIR_Node::S_push_local_reference& altr)
       {
+        if(altr.depth > UINT16_MAX)
+          ASTERIA_THROW_RUNTIME_ERROR((
+              "Scopes nested too deeply (depth `$1` exceeds `$2`)"),
+              altr.depth, UINT16_MAX);
+
         AVMC_Queue::Uparam up;
-        up.u32 = altr.depth;
-        up.u16 = static_cast<uint16_t>(altr.hint);
+        up.u16 = static_cast<uint16_t>(altr.depth);
+        up.u32 = altr.slot;
         return up;
       }
 
@@ -1042,19 +1214,24 @@ struct Traits_push_local_reference
       {
         // Get the context.
         Executive_Context* qctx = &ctx;
-        for(uint32_t k = 0;  k != up.u32;  ++k)
+        for(uint32_t k = 0;  k != up.u16;  ++k)
           qctx = qctx->get_parent_opt();
 
-        // Look for the name in the context.
-        size_t hint = up.u16;
-        auto qref = qctx->get_named_reference_with_hint_opt(hint, name);
-        if(!qref)
-          ASTERIA_THROW_RUNTIME_ERROR((
-              "Undeclared identifier `$1`"),
-              name);
+        // Load the reference from its frame slot. Pre-defined references
+        // have no slots, and are looked up by name.
+        const Reference* qref;
+        if(ROCKET_EXPECT(up.u32 != UINT32_MAX))
+          qref = qctx->get_local_slot_opt(up.u32);
+        else {
+          qref = qctx->get_named_reference_opt(name);
+          if(!qref)
+            ASTERIA_THROW_RUNTIME_ERROR((
+                "Undeclared identifier `$1`"),
+                name);
+        }
 
         // Check if control flow has bypassed its initialization.
-        if(qref->is_invalid())
+        if(!qref || qref->is_invalid())
           ASTERIA_THROW_RUNTIME_ERROR((
               "Use of bypassed variable or reference `$1`"),
               name);
@@ -1099,7 +1276,18 @@ struct Traits_define_function
         sp.sloc = altr.sloc;
         sp.func = altr.func;
         sp.params = altr.params;
-        sp.code_body = altr.code_body;
+
+        // If the body is to be optimized with captured references, it has
+        // to be rebound for each closure. Otherwise, solidify it only once,
+        // and closures will share it.
+        if(altr.opts.optimization_level >= 3) {
+          sp.code_body = altr.code_body;
+          return sp;
+        }
+
+        AIR_Optimizer optmz(altr.opts);
+        optmz.share(altr.params, altr.code_body, sp.captures);
+        sp.proto = optmz.create_prototype(altr.sloc, altr.func);
         return sp;
       }
 
@@ -1107,12 +1295,49 @@ struct Traits_define_function
     AIR_Status
     execute(Executive_Context& ctx, const Sparam_func& sp)
       {
-        // Rewrite nodes in the body as necessary.
-        AIR_Optimizer optmz(sp.opts);
-        optmz.rebind(&ctx, sp.params, sp.code_body);
-        auto qtarget = optmz.create_function(sp.sloc, sp.func);
+        if(ROCKET_UNEXPECT(!sp.proto)) {
+          // Rewrite nodes in the body as necessary.
+          AIR_Optimizer optmz(sp.opts);
+          optmz.rebind(&ctx, sp.params, ctx.global(), sp.code_body);
+          auto qtarget = optmz.create_function(sp.sloc, sp.func);
+
+          // Push the function as a temporary.
+          ctx.stack().push().set_temporary(::std::move(qtarget));
+          return air_status_next;
+        }
+
+        // Capture references from enclosing contexts.
+        cow_vector<Reference> captures;
+        captures.reserve(sp.captures.size());
+
+        for(const auto& capt : sp.captures) {
+          Executive_Context* qctx = &ctx;
+          for(uint32_t k = 0;  k != capt.depth;  ++k)
+            qctx = qctx->get_parent_opt();
+
+          const Reference* qref;
+          if(capt.slot != UINT32_MAX)
+            qref = qctx->get_local_slot_opt(capt.slot);
+          else {
+            qref = qctx->get_named_reference_opt(capt.name);
+            if(!qref)
+              ASTERIA_THROW_RUNTIME_ERROR((
+                  "Undeclared identifier `$1`"),
+                  capt.name);
+          }
+
+          // Check if control flow has bypassed its initialization.
+          if(!qref || qref->is_invalid())
+            ASTERIA_THROW_RUNTIME_ERROR((
+                "Use of bypassed variable or reference `$1`"),
+                capt.name);
+
+          captures.emplace_back(*qref);
+        }
 
         // Push the function as a temporary.
+        auto qtarget = ::rocket::make_refcnt<Instantiated_Function>(sp.proto,
+                                                  ::std::move(captures));
         ctx.stack().push().set_temporary(::std::move(qtarget));
         return air_status_next;
       }
@@ -1229,11 +1454,11 @@ do_invoke_nontail(Reference& self, const Source_Location& sloc, const cow_functi
 
 AIR_Status
 do_invoke_tail(Reference& self, const Source_Location& sloc, const cow_function& target,
-               PTC_Aware ptc, Reference_Stack&& stack)
+               Global_Context& global, PTC_Aware ptc, Reference_Stack&& stack)
   {
     // Set packed arguments for this PTC, which will be unpacked outside.
     stack.push() = ::std::move(self);
-    self.set_ptc_args(::rocket::make_refcnt<PTC_Arguments>(
+    self.set_ptc_args(global.call_pool().allocate_ptc_arguments(
               sloc, ptc, target, ::std::move(stack)));
 
     // Force `air_status_return_ref` if control flow reaches the end of a function.
@@ -1321,7 +1546,7 @@ struct Traits_function_call
 
         return ROCKET_EXPECT(ptc == ptc_aware_none)
                  ? do_invoke_nontail(self, sloc, target, ctx.global(), ::std::move(alt_stack))
-                 : do_invoke_tail(self, sloc, target, ptc, ::std::move(alt_stack));
+                 : do_invoke_tail(self, sloc, target, ctx.global(), ptc, ::std::move(alt_stack));
       }
   };
 
@@ -1348,9 +1573,14 @@ struct Traits_member_access
     AIR_Status
     execute(Executive_Context& ctx, phsh_stringR name)
       {
+        // Reading a member of an object never fails, so if the parent is an
+        // object, the key needn't be looked up here. It will be looked up
+        // when the reference is dereferenced.
         auto& ref = ctx.stack().mut_top();
+        const auto& parent = ref.dereference_readonly();
         ref.push_modifier_object_key(name);
-        ref.dereference_readonly();
+        if(ROCKET_UNEXPECT(!parent.is_object()))
+          ref.dereference_readonly();
         return air_status_next;
       }
   };
@@ -2778,15 +3008,10 @@ struct Traits_apply_xop_cmp_lt
         return up;
       }
 
-    ROCKET_FLATTEN static
-    AIR_Status
-    execute(Executive_Context& ctx, AVMC_Queue::Uparam up)
+    static
+    void
+    apply(Value& lhs, const Value& rhs)
       {
-        // This operator is binary.
-        const auto& rhs = ctx.stack().top().dereference_readonly();
-        ctx.stack().pop();
-        auto& lhs = do_get_first_operand(ctx.stack(), up.u8v[0]);  // assign
-
         // Check whether the LHS operand is less than the RHS operand.
         // Throw an exception if they are unordered.
         auto cmp = lhs.compare(rhs);
@@ -2796,6 +3021,40 @@ struct Traits_apply_xop_cmp_lt
               lhs, rhs);
 
         lhs = cmp == compare_less;
+      }
+
+    // These are fast paths for operands of the same type.
+    // See `do_execute_type_feedback()`.
+    static
+    void
+    apply_integer(Value& lhs, const Value& rhs)
+      {
+        lhs = lhs.as_integer() < rhs.as_integer();
+      }
+
+    static
+    void
+    apply_real(Value& lhs, const Value& rhs)
+      {
+        // Unordered operands are handled by the generic path, which throws
+        // an exception.
+        V_real x = lhs.as_real();
+        V_real y = rhs.as_real();
+        if(ROCKET_UNEXPECT(::std::isunordered(x, y)))
+          return apply(lhs, rhs);
+
+        lhs = x < y;
+      }
+
+    ROCKET_FLATTEN static
+    AIR_Status
+    execute(Executive_Context& ctx, AVMC_Queue::Uparam up)
+      {
+        // This operator is binary.
+        const auto& rhs = ctx.stack().top().dereference_readonly();
+        ctx.stack().pop();
+        auto& lhs = do_get_first_operand(ctx.stack(), up.u8v[0]);  // assign
+        apply(lhs, rhs);
         return air_status_next;
       }
   };
@@ -2821,15 +3080,10 @@ struct Traits_apply_xop_cmp_gt
         return up;
       }
 
-    ROCKET_FLATTEN static
-    AIR_Status
-    execute(Executive_Context& ctx, AVMC_Queue::Uparam up)
+    static
+    void
+    apply(Value& lhs, const Value& rhs)
       {
-        // This operator is binary.
-        const auto& rhs = ctx.stack().top().dereference_readonly();
-        ctx.stack().pop();
-        auto& lhs = do_get_first_operand(ctx.stack(), up.u8v[0]);  // assign
-
         // Check whether the LHS operand is greater than the RHS operand.
         // Throw an exception if they are unordered.
         auto cmp = lhs.compare(rhs);
@@ -2839,6 +3093,40 @@ struct Traits_apply_xop_cmp_gt
               lhs, rhs);
 
         lhs = cmp == compare_greater;
+      }
+
+    // These are fast paths for operands of the same type.
+    // See `do_execute_type_feedback()`.
+    static
+    void
+    apply_integer(Value& lhs, const Value& rhs)
+      {
+        lhs = lhs.as_integer() > rhs.as_integer();
+      }
+
+    static
+    void
+    apply_real(Value& lhs, const Value& rhs)
+      {
+        // Unordered operands are handled by the generic path, which throws
+        // an exception.
+        V_real x = lhs.as_real();
+        V_real y = rhs.as_real();
+        if(ROCKET_UNEXPECT(::std::isunordered(x, y)))
+          return apply(lhs, rhs);
+
+        lhs = x > y;
+      }
+
+    ROCKET_FLATTEN static
+    AIR_Status
+    execute(Executive_Context& ctx, AVMC_Queue::Uparam up)
+      {
+        // This operator is binary.
+        const auto& rhs = ctx.stack().top().dereference_readonly();
+        ctx.stack().pop();
+        auto& lhs = do_get_first_operand(ctx.stack(), up.u8v[0]);  // assign
+        apply(lhs, rhs);
         return air_status_next;
       }
   };
@@ -2864,15 +3152,10 @@ struct Traits_apply_xop_cmp_lte
         return up;
       }
 
-    ROCKET_FLATTEN static
-    AIR_Status
-    execute(Executive_Context& ctx, AVMC_Queue::Uparam up)
+    static
+    void
+    apply(Value& lhs, const Value& rhs)
       {
-        // This operator is binary.
-        const auto& rhs = ctx.stack().top().dereference_readonly();
-        ctx.stack().pop();
-        auto& lhs = do_get_first_operand(ctx.stack(), up.u8v[0]);  // assign
-
         // Check whether the LHS operand is less than or equal to the RHS operand.
         // Throw an exception if they are unordered.
         auto cmp = lhs.compare(rhs);
@@ -2882,6 +3165,40 @@ struct Traits_apply_xop_cmp_lte
               lhs, rhs);
 
         lhs = cmp != compare_greater;
+      }
+
+    // These are fast paths for operands of the same type.
+    // See `do_execute_type_feedback()`.
+    static
+    void
+    apply_integer(Value& lhs, const Value& rhs)
+      {
+        lhs = lhs.as_integer() <= rhs.as_integer();
+      }
+
+    static
+    void
+    apply_real(Value& lhs, const Value& rhs)
+      {
+        // Unordered operands are handled by the generic path, which throws
+        // an exception.
+        V_real x = lhs.as_real();
+        V_real y = rhs.as_real();
+        if(ROCKET_UNEXPECT(::std::isunordered(x, y)))
+          return apply(lhs, rhs);
+
+        lhs = x <= y;
+      }
+
+    ROCKET_FLATTEN static
+    AIR_Status
+    execute(Executive_Context& ctx, AVMC_Queue::Uparam up)
+      {
+        // This operator is binary.
+        const auto& rhs = ctx.stack().top().dereference_readonly();
+        ctx.stack().pop();
+        auto& lhs = do_get_first_operand(ctx.stack(), up.u8v[0]);  // assign
+        apply(lhs, rhs);
         return air_status_next;
       }
   };
@@ -2907,15 +3224,10 @@ struct Traits_apply_xop_cmp_gte
         return up;
       }
 
-    ROCKET_FLATTEN static
-    AIR_Status
-    execute(Executive_Context& ctx, AVMC_Queue::Uparam up)
+    static
+    void
+    apply(Value& lhs, const Value& rhs)
       {
-        // This operator is binary.
-        const auto& rhs = ctx.stack().top().dereference_readonly();
-        ctx.stack().pop();
-        auto& lhs = do_get_first_operand(ctx.stack(), up.u8v[0]);  // assign
-
         // Check whether the LHS operand is greater than or equal to the RHS operand.
         // Throw an exception if they are unordered.
         auto cmp = lhs.compare(rhs);
@@ -2925,29 +3237,29 @@ struct Traits_apply_xop_cmp_gte
               lhs, rhs);
 
         lhs = cmp != compare_less;
-        return air_status_next;
       }
-  };
-
-struct Traits_apply_xop_cmp_3way
-  {
-    // `up` is `assign`.
-    // `sp` is unused.
 
+    // These are fast paths for operands of the same type.
+    // See `do_execute_type_feedback()`.
     static
-    const Source_Location&
-    get_symbols(const AIR_Node::S_apply_operator& altr)
+    void
+    apply_integer(Value& lhs, const Value& rhs)
       {
-        return altr.sloc;
+        lhs = lhs.as_integer() >= rhs.as_integer();
       }
 
     static
-    AVMC_Queue::Uparam
-    make_uparam(bool& /*reachable*/, const AIR_Node::S_apply_operator& altr)
+    void
+    apply_real(Value& lhs, const Value& rhs)
       {
-        AVMC_Queue::Uparam up;
-        up.u8v[0] = altr.assign;
-        return up;
+        // Unordered operands are handled by the generic path, which throws
+        // an exception.
+        V_real x = lhs.as_real();
+        V_real y = rhs.as_real();
+        if(ROCKET_UNEXPECT(::std::isunordered(x, y)))
+          return apply(lhs, rhs);
+
+        lhs = x >= y;
       }
 
     ROCKET_FLATTEN static
@@ -2958,7 +3270,41 @@ struct Traits_apply_xop_cmp_3way
         const auto& rhs = ctx.stack().top().dereference_readonly();
         ctx.stack().pop();
         auto& lhs = do_get_first_operand(ctx.stack(), up.u8v[0]);  // assign
-
+        apply(lhs, rhs);
+        return air_status_next;
+      }
+  };
+
+struct Traits_apply_xop_cmp_3way
+  {
+    // `up` is `assign`.
+    // `sp` is unused.
+
+    static
+    const Source_Location&
+    get_symbols(const AIR_Node::S_apply_operator& altr)
+      {
+        return altr.sloc;
+      }
+
+    static
+    AVMC_Queue::Uparam
+    make_uparam(bool& /*reachable*/, const AIR_Node::S_apply_operator& altr)
+      {
+        AVMC_Queue::Uparam up;
+        up.u8v[0] = altr.assign;
+        return up;
+      }
+
+    ROCKET_FLATTEN static
+    AIR_Status
+    execute(Executive_Context& ctx, AVMC_Queue::Uparam up)
+      {
+        // This operator is binary.
+        const auto& rhs = ctx.stack().top().dereference_readonly();
+        ctx.stack().pop();
+        auto& lhs = do_get_first_operand(ctx.stack(), up.u8v[0]);  // assign
+
         // Perform 3-way comparison on both operands.
         // N.B. This is one of the few operators that work on all types.
         auto cmp = lhs.compare(rhs);
@@ -3043,15 +3389,10 @@ struct Traits_apply_xop_add
         return up;
       }
 
-    ROCKET_FLATTEN static
-    AIR_Status
-    execute(Executive_Context& ctx, AVMC_Queue::Uparam up)
+    static
+    void
+    apply(Value& lhs, const Value& rhs)
       {
-        // This operator is binary.
-        const auto& rhs = ctx.stack().top().dereference_readonly();
-        ctx.stack().pop();
-        auto& lhs = do_get_first_operand(ctx.stack(), up.u8v[0]);  // assign
-
         // For the `boolean` type, perform logical OR of the operands.
         // For the `integer` and `real` types, perform arithmetic addition.
         // For the `string` type, concatenate them.
@@ -3060,22 +3401,13 @@ struct Traits_apply_xop_add
             ROCKET_ASSERT(lhs.is_boolean());
             ROCKET_ASSERT(rhs.is_boolean());
             lhs.mut_boolean() |= rhs.as_boolean();
-            return air_status_next;
+            return;
           }
 
           case M_integer: {
             ROCKET_ASSERT(lhs.is_integer());
-            auto& x = lhs.mut_integer();
             ROCKET_ASSERT(rhs.is_integer());
-            auto y = rhs.as_integer();
-
-            V_integer oldx = x;
-            if(ROCKET_ADD_OVERFLOW(oldx, y, &x))
-              ASTERIA_THROW_RUNTIME_ERROR((
-                  "Integer addition overflow (operands were `$1` and `$2`)"),
-                  oldx, y);
-
-            return air_status_next;
+            return apply_integer(lhs, rhs);
           }
 
           case M_real | M_integer:
@@ -3083,14 +3415,14 @@ struct Traits_apply_xop_add
             ROCKET_ASSERT(lhs.is_real());
             ROCKET_ASSERT(rhs.is_real());
             lhs.mut_real() += rhs.as_real();
-            return air_status_next;
+            return;
           }
 
           case M_string: {
             ROCKET_ASSERT(lhs.is_string());
             ROCKET_ASSERT(rhs.is_string());
             lhs.mut_string() += rhs.as_string();
-            return air_status_next;
+            return;
           }
 
           default:
@@ -3099,6 +3431,41 @@ struct Traits_apply_xop_add
                 lhs, rhs);
         }
       }
+
+    // These are fast paths for operands of the same type.
+    // See `do_execute_type_feedback()`.
+    static
+    void
+    apply_integer(Value& lhs, const Value& rhs)
+      {
+        auto& x = lhs.mut_integer();
+        auto y = rhs.as_integer();
+
+        V_integer oldx = x;
+        if(ROCKET_ADD_OVERFLOW(oldx, y, &x))
+          ASTERIA_THROW_RUNTIME_ERROR((
+              "Integer addition overflow (operands were `$1` and `$2`)"),
+              oldx, y);
+      }
+
+    static
+    void
+    apply_real(Value& lhs, const Value& rhs)
+      {
+        lhs.mut_real() += rhs.as_real();
+      }
+
+    ROCKET_FLATTEN static
+    AIR_Status
+    execute(Executive_Context& ctx, AVMC_Queue::Uparam up)
+      {
+        // This operator is binary.
+        const auto& rhs = ctx.stack().top().dereference_readonly();
+        ctx.stack().pop();
+        auto& lhs = do_get_first_operand(ctx.stack(), up.u8v[0]);  // assign
+        apply(lhs, rhs);
+        return air_status_next;
+      }
   };
 
 struct Traits_apply_xop_sub
@@ -3122,15 +3489,10 @@ struct Traits_apply_xop_sub
         return up;
       }
 
-    ROCKET_FLATTEN static
-    AIR_Status
-    execute(Executive_Context& ctx, AVMC_Queue::Uparam up)
+    static
+    void
+    apply(Value& lhs, const Value& rhs)
       {
-        // This operator is binary.
-        const auto& rhs = ctx.stack().top().dereference_readonly();
-        ctx.stack().pop();
-        auto& lhs = do_get_first_operand(ctx.stack(), up.u8v[0]);  // assign
-
         // For the `boolean` type, perform logical XOR of the operands.
         // For the `integer` and `real` types, perform arithmetic subtraction.
         switch(lhs.type_mask() | rhs.type_mask()) {
@@ -3138,22 +3500,13 @@ struct Traits_apply_xop_sub
             ROCKET_ASSERT(lhs.is_boolean());
             ROCKET_ASSERT(rhs.is_boolean());
             lhs.mut_boolean() ^= rhs.as_boolean();
-            return air_status_next;
+            return;
           }
 
           case M_integer: {
             ROCKET_ASSERT(lhs.is_integer());
-            auto& x = lhs.mut_integer();
             ROCKET_ASSERT(rhs.is_integer());
-            auto y = rhs.as_integer();
-
-            V_integer oldx = x;
-            if(ROCKET_SUB_OVERFLOW(oldx, y, &x))
-              ASTERIA_THROW_RUNTIME_ERROR((
-                  "Integer subtraction overflow (operands were `$1` and `$2`)"),
-                  oldx, y);
-
-            return air_status_next;
+            return apply_integer(lhs, rhs);
           }
 
           case M_real | M_integer:
@@ -3161,7 +3514,7 @@ struct Traits_apply_xop_sub
             ROCKET_ASSERT(lhs.is_real());
             ROCKET_ASSERT(rhs.is_real());
             lhs.mut_real() -= rhs.as_real();
-            return air_status_next;
+            return;
           }
 
           default:
@@ -3170,6 +3523,41 @@ struct Traits_apply_xop_sub
                 lhs, rhs);
         }
       }
+
+    // These are fast paths for operands of the same type.
+    // See `do_execute_type_feedback()`.
+    static
+    void
+    apply_integer(Value& lhs, const Value& rhs)
+      {
+        auto& x = lhs.mut_integer();
+        auto y = rhs.as_integer();
+
+        V_integer oldx = x;
+        if(ROCKET_SUB_OVERFLOW(oldx, y, &x))
+          ASTERIA_THROW_RUNTIME_ERROR((
+              "Integer subtraction overflow (operands were `$1` and `$2`)"),
+              oldx, y);
+      }
+
+    static
+    void
+    apply_real(Value& lhs, const Value& rhs)
+      {
+        lhs.mut_real() -= rhs.as_real();
+      }
+
+    ROCKET_FLATTEN static
+    AIR_Status
+    execute(Executive_Context& ctx, AVMC_Queue::Uparam up)
+      {
+        // This operator is binary.
+        const auto& rhs = ctx.stack().top().dereference_readonly();
+        ctx.stack().pop();
+        auto& lhs = do_get_first_operand(ctx.stack(), up.u8v[0]);  // assign
+        apply(lhs, rhs);
+        return air_status_next;
+      }
   };
 
 struct Traits_apply_xop_mul
@@ -3193,15 +3581,10 @@ struct Traits_apply_xop_mul
         return up;
       }
 
-    ROCKET_FLATTEN static
-    AIR_Status
-    execute(Executive_Context& ctx, AVMC_Queue::Uparam up)
+    static
+    void
+    apply(Value& lhs, const Value& rhs)
       {
-        // This operator is binary.
-        const auto& rhs = ctx.stack().top().dereference_readonly();
-        ctx.stack().pop();
-        auto& lhs = do_get_first_operand(ctx.stack(), up.u8v[0]);  // assign
-
         // For the `boolean` type, perform logical AND of the operands.
         // For the `integer` and `real` types, perform arithmetic multiplication.
         // If either operand is an `integer` and the other is a `string`, duplicate the string.
@@ -3210,22 +3593,13 @@ struct Traits_apply_xop_mul
             ROCKET_ASSERT(lhs.is_boolean());
             ROCKET_ASSERT(rhs.is_boolean());
             lhs.mut_boolean() &= rhs.as_boolean();
-            return air_status_next;
+            return;
           }
 
           case M_integer: {
             ROCKET_ASSERT(lhs.is_integer());
-            auto& x = lhs.mut_integer();
             ROCKET_ASSERT(rhs.is_integer());
-            auto y = rhs.as_integer();
-
-            V_integer oldx = x;
-            if(ROCKET_MUL_OVERFLOW(oldx, y, &x))
-              ASTERIA_THROW_RUNTIME_ERROR((
-                  "Integer multiplication overflow (operands were `$1` and `$2`)"),
-                  oldx, y);
-
-            return air_status_next;
+            return apply_integer(lhs, rhs);
           }
 
           case M_real | M_integer:
@@ -3233,7 +3607,7 @@ struct Traits_apply_xop_mul
             ROCKET_ASSERT(lhs.is_real());
             ROCKET_ASSERT(rhs.is_real());
             lhs.mut_real() *= rhs.as_real();
-            return air_status_next;
+            return;
           }
 
           case M_string | M_integer: {
@@ -3270,7 +3644,7 @@ struct Traits_apply_xop_mul
                 ::std::memcpy(ptr + total, ptr, str.size() - total);
             }
             lhs = ::std::move(str);
-            return air_status_next;
+            return;
           }
 
           default:
@@ -3279,6 +3653,41 @@ struct Traits_apply_xop_mul
                 lhs, rhs);
         }
       }
+
+    // These are fast paths for operands of the same type.
+    // See `do_execute_type_feedback()`.
+    static
+    void
+    apply_integer(Value& lhs, const Value& rhs)
+      {
+        auto& x = lhs.mut_integer();
+        auto y = rhs.as_integer();
+
+        V_integer oldx = x;
+        if(ROCKET_MUL_OVERFLOW(oldx, y, &x))
+          ASTERIA_THROW_RUNTIME_ERROR((
+              "Integer multiplication overflow (operands were `$1` and `$2`)"),
+              oldx, y);
+      }
+
+    static
+    void
+    apply_real(Value& lhs, const Value& rhs)
+      {
+        lhs.mut_real() *= rhs.as_real();
+      }
+
+    ROCKET_FLATTEN static
+    AIR_Status
+    execute(Executive_Context& ctx, AVMC_Queue::Uparam up)
+      {
+        // This operator is binary.
+        const auto& rhs = ctx.stack().top().dereference_readonly();
+        ctx.stack().pop();
+        auto& lhs = do_get_first_operand(ctx.stack(), up.u8v[0]);  // assign
+        apply(lhs, rhs);
+        return air_status_next;
+      }
   };
 
 struct Traits_apply_xop_div
@@ -4317,7 +4726,7 @@ struct Traits_unpack_struct_object
 
 struct Traits_define_null_variable
   {
-    // `up` is `immutable`.
+    // `up` is `immutable`, `untracked` and the frame slot.
     // `sp` is the source location and name.
 
     static
@@ -4326,6 +4735,8 @@ struct Traits_define_null_variable
       {
         AVMC_Queue::Uparam up;
         up.u8v[0] = altr.immutable;
+        up.u8v[1] = altr.untracked;
+        up.u32 = altr.slot;
         return up;
       }
 
@@ -4355,8 +4766,9 @@ struct Traits_define_null_variable
 
         // Allocate an uninitialized variable.
         // Inject the variable into the current context.
-        const auto var = gcoll->create_variable();
-        ctx.mut_named_reference(sp.name).set_variable(var);
+        const auto var = up.u8v[1] ? gcoll->create_untracked_variable()
+                                   : gcoll->create_variable();
+        ctx.mut_local_slot(up.u32).set_variable(var);
         if(qhooks)
           qhooks->on_variable_declare(sp.sloc, sp.name);
 
@@ -4530,7 +4942,7 @@ struct Traits_variadic_call
 
         return ROCKET_EXPECT(ptc == ptc_aware_none)
                  ? do_invoke_nontail(self, sloc, target, ctx.global(), ::std::move(alt_stack))
-                 : do_invoke_tail(self, sloc, target, ptc, ::std::move(alt_stack));
+                 : do_invoke_tail(self, sloc, target, ctx.global(), ptc, ::std::move(alt_stack));
       }
   };
 
@@ -4681,31 +5093,31 @@ struct Traits_import_call
 
 struct Traits_declare_reference
   {
-    // `up` is unused.
-    // `sp` is the name;
+    // `up` is the frame slot.
+    // `sp` is unused.
 
     static
-    Sparam_name
-    make_sparam(bool& /*reachable*/, const AIR_Node::S_declare_reference& altr)
+    AVMC_Queue::Uparam
+    make_uparam(bool& /*reachable*/, const AIR_Node::S_declare_reference& altr)
       {
-        Sparam_name sp;
-        sp.name = altr.name;
-        return sp;
+        AVMC_Queue::Uparam up;
+        up.u32 = altr.slot;
+        return up;
       }
 
     ROCKET_FLATTEN static
     AIR_Status
-    execute(Executive_Context& ctx, const Sparam_name& sp)
+    execute(Executive_Context& ctx, AVMC_Queue::Uparam up)
       {
-        ctx.mut_named_reference(sp.name).set_invalid();
+        ctx.mut_local_slot(up.u32).set_invalid();
         return air_status_next;
       }
   };
 
 struct Traits_initialize_reference
   {
-    // `up` is unused.
-    // `sp` is the name;
+    // `up` is the frame slot.
+    // `sp` is unused.
 
     static
     const Source_Location&
@@ -4715,20 +5127,20 @@ struct Traits_initialize_reference
       }
 
     static
-    Sparam_name
-    make_sparam(bool& /*reachable*/, const AIR_Node::S_initialize_reference& altr)
+    AVMC_Queue::Uparam
+    make_uparam(bool& /*reachable*/, const AIR_Node::S_initialize_reference& altr)
       {
-        Sparam_name sp;
-        sp.name = altr.name;
-        return sp;
+        AVMC_Queue::Uparam up;
+        up.u32 = altr.slot;
+        return up;
       }
 
     ROCKET_FLATTEN static
     AIR_Status
-    execute(Executive_Context& ctx, const Sparam_name& sp)
+    execute(Executive_Context& ctx, AVMC_Queue::Uparam up)
       {
         // Pop a reference from the stack. Ensure it is dereferenceable.
-        ctx.mut_named_reference(sp.name) = ::std::move(ctx.stack().mut_top());
+        ctx.mut_local_slot(up.u32) = ::std::move(ctx.stack().mut_top());
         ctx.stack().pop();
         return air_status_next;
       }
@@ -5266,6 +5678,149 @@ struct Traits_apply_xop_random
       }
   };
 
+// These are superinstructions, which are fused from common sequences of nodes
+// when they are solidified. Each of them behaves the same as the nodes that it
+// replaces, but requires fewer dispatches and stack operations. As a fused node
+// has only one source location, the location of its last node is used.
+
+struct S_fused_local_member
+  {
+    const AIR_Node::S_push_local_reference& ref;
+    const AIR_Node::S_member_access& memb;
+  };
+
+struct Traits_fused_local_member
+  {
+    // `up` is the depth and frame slot.
+    // `sp` is the name of the local reference and the member.
+
+    static
+    const Source_Location&
+    get_symbols(const S_fused_local_member& altr)
+      {
+        return altr.memb.sloc;
+      }
+
+    static
+    AVMC_Queue::Uparam
+    make_uparam(bool& reachable, const S_fused_local_member& altr)
+      {
+        return Traits_push_local_reference::make_uparam(reachable, altr.ref);
+      }
+
+    static
+    Sparam_local_member
+    make_sparam(bool& /*reachable*/, const S_fused_local_member& altr)
+      {
+        Sparam_local_member sp;
+        sp.name = altr.ref.name;
+        sp.memb = altr.memb.name;
+        return sp;
+      }
+
+    ROCKET_FLATTEN static
+    AIR_Status
+    execute(Executive_Context& ctx, AVMC_Queue::Uparam up, const Sparam_local_member& sp)
+      {
+        Traits_push_local_reference::execute(ctx, up, sp.name);
+        return Traits_member_access::execute(ctx, sp.memb);
+      }
+  };
+
+struct S_fused_local_temp_xop
+  {
+    const AIR_Node::S_push_local_reference& ref;
+    const AIR_Node::S_push_temporary& temp;
+    const AIR_Node::S_apply_operator& xop;
+  };
+
+template<typename XopTraitsT>
+struct Traits_fused_local_temp_xop
+  {
+    // `up` is the depth and frame slot.
+    // `sp` is the name of the local reference, the RHS operand and `assign`.
+
+    static
+    const Source_Location&
+    get_symbols(const S_fused_local_temp_xop& altr)
+      {
+        return altr.xop.sloc;
+      }
+
+    static
+    AVMC_Queue::Uparam
+    make_uparam(bool& reachable, const S_fused_local_temp_xop& altr)
+      {
+        return Traits_push_local_reference::make_uparam(reachable, altr.ref);
+      }
+
+    static
+    Sparam_local_temp_xop
+    make_sparam(bool& /*reachable*/, const S_fused_local_temp_xop& altr)
+      {
+        Sparam_local_temp_xop sp;
+        sp.name = altr.ref.name;
+        sp.value = altr.temp.value;
+        sp.assign = altr.xop.assign;
+        return sp;
+      }
+
+    ROCKET_FLATTEN static
+    AIR_Status
+    execute(Executive_Context& ctx, AVMC_Queue::Uparam up, const Sparam_local_temp_xop& sp)
+      {
+        // The RHS operand is not pushed, but taken from `sp` directly.
+        Traits_push_local_reference::execute(ctx, up, sp.name);
+        auto& lhs = do_get_first_operand(ctx.stack(), sp.assign);
+        XopTraitsT::apply(lhs, sp.value);
+        return air_status_next;
+      }
+  };
+
+struct S_fused_temp_call
+  {
+    const AIR_Node::S_push_temporary& temp;
+    const AIR_Node::S_function_call& call;
+  };
+
+struct Traits_fused_temp_call
+  {
+    // `up` is `nargs` and `ptc`.
+    // `sp` is the source location and the last argument.
+
+    static
+    const Source_Location&
+    get_symbols(const S_fused_temp_call& altr)
+      {
+        return altr.call.sloc;
+      }
+
+    static
+    AVMC_Queue::Uparam
+    make_uparam(bool& reachable, const S_fused_temp_call& altr)
+      {
+        return Traits_function_call::make_uparam(reachable, altr.call);
+      }
+
+    static
+    Sparam_temp_call
+    make_sparam(bool& /*reachable*/, const S_fused_temp_call& altr)
+      {
+        Sparam_temp_call sp;
+        sp.sloc = altr.call.sloc;
+        sp.value = altr.temp.value;
+        return sp;
+      }
+
+    static
+    AIR_Status
+    execute(Executive_Context& ctx, AVMC_Queue::Uparam up, const Sparam_temp_call& sp)
+      {
+        ctx.stack().push().set_temporary(sp.value);
+        return Traits_function_call::execute(ctx, up, sp.sloc);
+      }
+  };
+
 // Finally...
 template<typename TraitsT, typename NodeT, typename = void>
 struct symbol_getter
@@ -5420,6 +5975,138 @@ do_solidify(AVMC_Queue& queue, const NodeT& altr)
     return reachable;
   }
 
+// These are executors for binary operators with type feedback. A node starts
+// with `do_execute_type_feedback()`, which records types of operands that it
+// sees on its first execution, and rewrites itself in place. If both operands
+// are integers or reals, the node is specialized for them; otherwise it becomes
+// generic. Specialized nodes check types of operands before taking their fast
+// paths, and fall back to the generic path if the check fails.
+template<typename TraitsT>
+AIR_Status
+do_execute_type_integer(Executive_Context& ctx, const AVMC_Queue::Header* head)
+  {
+    // This operator is binary.
+    const auto& rhs = ctx.stack().top().dereference_readonly();
+    ctx.stack().pop();
+    auto& lhs = do_get_first_operand(ctx.stack(), head->uparam.u8v[0]);  // assign
+
+    if(ROCKET_EXPECT((lhs.type_mask() | rhs.type_mask()) == M_integer))
+      TraitsT::apply_integer(lhs, rhs);
+    else
+      TraitsT::apply(lhs, rhs);
+    return air_status_next;
+  }
+
+template<typename TraitsT>
+AIR_Status
+do_execute_type_real(Executive_Context& ctx, const AVMC_Queue::Header* head)
+  {
+    // This operator is binary.
+    const auto& rhs = ctx.stack().top().dereference_readonly();
+    ctx.stack().pop();
+    auto& lhs = do_get_first_operand(ctx.stack(), head->uparam.u8v[0]);  // assign
+
+    if(ROCKET_EXPECT((lhs.type_mask() | rhs.type_mask()) == M_real))
+      TraitsT::apply_real(lhs, rhs);
+    else
+      TraitsT::apply(lhs, rhs);
+    return air_status_next;
+  }
+
+template<typename TraitsT>
+AIR_Status
+do_execute_type_feedback(Executive_Context& ctx, const AVMC_Queue::Header* head)
+  {
+    // This operator is binary.
+    const auto& rhs = ctx.stack().top().dereference_readonly();
+    ctx.stack().pop();
+    auto& lhs = do_get_first_operand(ctx.stack(), head->uparam.u8v[0]);  // assign
+
+    // Specialize this node for the types of its operands.
+    switch(lhs.type_mask() | rhs.type_mask()) {
+      case M_integer:
+        AVMC_Queue::rewrite_executor(head, do_execute_type_integer<TraitsT>);
+        break;
+
+      case M_real:
+        AVMC_Queue::rewrite_executor(head, do_execute_type_real<TraitsT>);
+        break;
+
+      default:
+        AVMC_Queue::rewrite_executor(head,
+                solidify_disp<TraitsT, AIR_Node::S_apply_operator, true, false>::thunk);
+        break;
+    }
+
+    TraitsT::apply(lhs, rhs);
+    return air_status_next;
+  }
+
+template<typename TraitsT>
+inline
+bool
+do_solidify_type_feedback(AVMC_Queue& queue, const AIR_Node::S_apply_operator& altr)
+  {
+    bool reachable = true;
+    queue.append(do_execute_type_feedback<TraitsT>,
+        symbol_getter<TraitsT, AIR_Node::S_apply_operator>::opt(altr),
+        TraitsT::make_uparam(reachable, altr));
+    return reachable;
+  }
+
+// Try fusing nodes beginning at `code[k]` into a superinstruction. The return
+// value is the number of nodes that have been consumed, or zero if no known
+// sequence has been found.
+size_t
+do_solidify_fused_opt(bool& reachable, AVMC_Queue& queue, const cow_vector<AIR_Node>& code,
+                      size_t k)
+  {
+    auto qnext = [&](size_t n, AIR_Node::Index index) {
+      return (code.size() - k > n) && (code[k+n].index() == index);
+    };
+
+    if(qnext(0, AIR_Node::index_push_local_reference)) {
+      const auto& ref = *(code[k].get_opt<AIR_Node::S_push_local_reference>());
+
+      // `push_local_reference`, `push_temporary`, `apply_operator`
+      if(qnext(1, AIR_Node::index_push_temporary) && qnext(2, AIR_Node::index_apply_operator)) {
+        S_fused_local_temp_xop altr = { ref, *(code[k+1].get_opt<AIR_Node::S_push_temporary>()),
+                                        *(code[k+2].get_opt<AIR_Node::S_apply_operator>()) };
+        if(altr.xop.xop == xop_add) {
+          reachable = do_solidify<Traits_fused_local_temp_xop<
+                                       Traits_apply_xop_add>>(queue, altr);
+          return 3;
+        }
+
+        if(altr.xop.xop == xop_cmp_lt) {
+          reachable = do_solidify<Traits_fused_local_temp_xop<
+                                       Traits_apply_xop_cmp_lt>>(queue, altr);
+          return 3;
+        }
+      }
+
+      // `push_local_reference`, `member_access`
+      if(qnext(1, AIR_Node::index_member_access)) {
+        S_fused_local_member altr = { ref, *(code[k+1].get_opt<AIR_Node::S_member_access>()) };
+        reachable = do_solidify<Traits_fused_local_member>(queue, altr);
+        return 2;
+      }
+    }
+
+    if(qnext(0, AIR_Node::index_push_temporary)) {
+      const auto& temp = *(code[k].get_opt<AIR_Node::S_push_temporary>());
+
+      // `push_temporary`, `function_call`
+      if(qnext(1, AIR_Node::index_function_call)) {
+        S_fused_temp_call altr = { temp, *(code[k+1].get_opt<AIR_Node::S_function_call>()) };
+        reachable = do_solidify<Traits_fused_temp_call>(queue, altr);
+        return 2;
+      }
+    }
+
+    return 0;
+  }
+
 }  // namespace
 
 opt<AIR_Node>
@@ -5451,12 +6138,11 @@ rebind_opt(Abstract_Context& ctx) const
         const auto& altr = this->m_stor.as<index_if_statement>();
 
         // Rebind both branches.
-        Analytic_Context ctx_body(Analytic_Context::M_plain(), ctx);
         bool dirty = false;
         auto bound = altr;
 
-        do_rebind_nodes(dirty, bound.code_true, ctx_body);
-        do_rebind_nodes(dirty, bound.code_false, ctx_body);
+        do_rebind_nodes(dirty, bound.code_true, ctx);
+        do_rebind_nodes(dirty, bound.code_false, ctx);
 
         return do_return_rebound_opt(dirty, ::std::move(bound));
       }
@@ -5479,12 +6165,11 @@ rebind_opt(Abstract_Context& ctx) const
         const auto& altr = this->m_stor.as<index_do_while_statement>();
 
         // Rebind the body and the condition.
-        Analytic_Context ctx_body(Analytic_Context::M_plain(), ctx);
         bool dirty = false;
         auto bound = altr;
 
-        do_rebind_nodes(dirty, bound.code_body, ctx_body);
-        do_rebind_nodes(dirty, bound.code_cond, ctx);  // this is not part of the body!
+        do_rebind_nodes(dirty, bound.code_body, ctx);
+        do_rebind_nodes(dirty, bound.code_cond, ctx);
 
         return do_return_rebound_opt(dirty, ::std::move(bound));
       }
@@ -5493,12 +6178,11 @@ rebind_opt(Abstract_Context& ctx) const
         const auto& altr = this->m_stor.as<index_while_statement>();
 
         // Rebind the condition and the body.
-        Analytic_Context ctx_body(Analytic_Context::M_plain(), ctx);
         bool dirty = false;
         auto bound = altr;
 
-        do_rebind_nodes(dirty, bound.code_cond, ctx);  // this is not part of the body!
-        do_rebind_nodes(dirty, bound.code_body, ctx_body);
+        do_rebind_nodes(dirty, bound.code_cond, ctx);
+        do_rebind_nodes(dirty, bound.code_body, ctx);
 
         return do_return_rebound_opt(dirty, ::std::move(bound));
       }
@@ -5508,12 +6192,11 @@ rebind_opt(Abstract_Context& ctx) const
 
         // Rebind the range initializer and the body.
         Analytic_Context ctx_for(Analytic_Context::M_plain(), ctx);
-        Analytic_Context ctx_body(Analytic_Context::M_plain(), ctx_for);
         bool dirty = false;
         auto bound = altr;
 
         do_rebind_nodes(dirty, bound.code_init, ctx_for);
-        do_rebind_nodes(dirty, bound.code_body, ctx_body);
+        do_rebind_nodes(dirty, bound.code_body, ctx_for);
 
         return do_return_rebound_opt(dirty, ::std::move(bound));
       }
@@ -5523,14 +6206,13 @@ rebind_opt(Abstract_Context& ctx) const
 
         // Rebind the initializer, the condition, the loop increment and the body.
         Analytic_Context ctx_for(Analytic_Context::M_plain(), ctx);
-        Analytic_Context ctx_body(Analytic_Context::M_plain(), ctx_for);
         bool dirty = false;
         auto bound = altr;
 
         do_rebind_nodes(dirty, bound.code_init, ctx_for);
         do_rebind_nodes(dirty, bound.code_cond, ctx_for);
         do_rebind_nodes(dirty, bound.code_step, ctx_for);
-        do_rebind_nodes(dirty, bound.code_body, ctx_body);
+        do_rebind_nodes(dirty, bound.code_body, ctx_for);
 
         return do_return_rebound_opt(dirty, ::std::move(bound));
       }
@@ -5539,12 +6221,12 @@ rebind_opt(Abstract_Context& ctx) const
         const auto& altr = this->m_stor.as<index_try_statement>();
 
         // Rebind the `try` and `catch` clauses.
-        Analytic_Context ctx_body(Analytic_Context::M_plain(), ctx);
+        Analytic_Context ctx_catch(Analytic_Context::M_plain(), ctx);
         bool dirty = false;
         auto bound = altr;
 
-        do_rebind_nodes(dirty, bound.code_try, ctx_body);
-        do_rebind_nodes(dirty, bound.code_catch, ctx_body);
+        do_rebind_nodes(dirty, bound.code_try, ctx);
+        do_rebind_nodes(dirty, bound.code_catch, ctx_catch);
 
         return do_return_rebound_opt(dirty, ::std::move(bound));
       }
@@ -5568,13 +6250,20 @@ rebind_opt(Abstract_Context& ctx) const
         if(qctx->is_analytic())
           return nullopt;
 
-        // Look for the name in the context.
-        auto qref = qctx->get_named_reference_opt(altr.name);
-        if(!qref)
-          return nullopt;
+        // Load the reference from its frame slot, or look for the name in the
+        // context if it is a pre-defined one.
+        // Local references are never bound to the global context.
+        const Reference* qref;
+        if(altr.slot != UINT32_MAX)
+          qref = static_cast<Executive_Context*>(qctx)->get_local_slot_opt(altr.slot);
+        else {
+          qref = qctx->get_named_reference_opt(altr.name);
+          if(!qref)
+            return nullopt;
+        }
 
         // Check if control flow has bypassed its initialization.
-        if(qref->is_invalid())
+        if(!qref || qref->is_invalid())
           ASTERIA_THROW_RUNTIME_ERROR((
               "Use of bypassed variable or reference `$1`"),
               altr.name);
@@ -5873,16 +6562,16 @@ solidify(AVMC_Queue& queue) const
             return do_solidify<Traits_apply_xop_cmp_ne>(queue, altr);
 
           case xop_cmp_lt:
-            return do_solidify<Traits_apply_xop_cmp_lt>(queue, altr);
+            return do_solidify_type_feedback<Traits_apply_xop_cmp_lt>(queue, altr);
 
           case xop_cmp_gt:
-            return do_solidify<Traits_apply_xop_cmp_gt>(queue, altr);
+            return do_solidify_type_feedback<Traits_apply_xop_cmp_gt>(queue, altr);
 
           case xop_cmp_lte:
-            return do_solidify<Traits_apply_xop_cmp_lte>(queue, altr);
+            return do_solidify_type_feedback<Traits_apply_xop_cmp_lte>(queue, altr);
 
           case xop_cmp_gte:
-            return do_solidify<Traits_apply_xop_cmp_gte>(queue, altr);
+            return do_solidify_type_feedback<Traits_apply_xop_cmp_gte>(queue, altr);
 
           case xop_cmp_3way:
             return do_solidify<Traits_apply_xop_cmp_3way>(queue, altr);
@@ -5891,13 +6580,13 @@ solidify(AVMC_Queue& queue) const
             return do_solidify<Traits_apply_xop_cmp_un>(queue, altr);
 
           case xop_add:
-            return do_solidify<Traits_apply_xop_add>(queue, altr);
+            return do_solidify_type_feedback<Traits_apply_xop_add>(queue, altr);
 
           case xop_sub:
-            return do_solidify<Traits_apply_xop_sub>(queue, altr);
+            return do_solidify_type_feedback<Traits_apply_xop_sub>(queue, altr);
 
           case xop_mul:
-            return do_solidify<Traits_apply_xop_mul>(queue, altr);
+            return do_solidify_type_feedback<Traits_apply_xop_mul>(queue, altr);
 
           case xop_div:
             return do_solidify<Traits_apply_xop_div>(queue, altr);
@@ -6030,6 +6719,101 @@ solidify(AVMC_Queue& queue) const
     }
   }
 
+bool
+AIR_Node::
+solidify_all(AVMC_Queue& queue, const cow_vector<AIR_Node>& code)
+  {
+    size_t k = 0;
+    while(k != code.size()) {
+      // Prefer superinstructions to individual nodes.
+      bool reachable = true;
+      size_t nfused = do_solidify_fused_opt(reachable, queue, code, k);
+      if(nfused == 0) {
+        reachable = code[k].solidify(queue);
+        nfused = 1;
+      }
+
+      // Stop at the first node that terminates control flow.
+      if(!reachable)
+        return false;
+
+      k += nfused;
+    }
+    return true;
+  }
+
+bool
+AIR_Node::
+is_terminator() const noexcept
+  {
+    switch(this->index()) {
+      case index_execute_block:
+        return do_is_terminated(this->m_stor.as<index_execute_block>().code_body);
+
+      case index_if_statement: {
+        const auto& altr = this->m_stor.as<index_if_statement>();
+        return do_is_terminated(altr.code_true) && do_is_terminated(altr.code_false);
+      }
+
+      case index_do_while_statement:
+        return do_is_terminated(this->m_stor.as<index_do_while_statement>().code_body);
+
+      case index_try_statement: {
+        const auto& altr = this->m_stor.as<index_try_statement>();
+        return do_is_terminated(altr.code_try) && do_is_terminated(altr.code_catch);
+      }
+
+      case index_throw_statement:
+      case index_simple_status:
+      case index_return_value:
+        return true;
+
+      case index_function_call:
+        return this->m_stor.as<index_function_call>().ptc != ptc_aware_none;
+
+      case index_branch_expression: {
+        const auto& altr = this->m_stor.as<index_branch_expression>();
+        return do_is_terminated(altr.code_true) && do_is_terminated(altr.code_false);
+      }
+
+      case index_clear_stack:
+      case index_declare_variable:
+      case index_initialize_variable:
+      case index_switch_statement:
+      case index_while_statement:
+      case index_for_each_statement:
+      case index_for_statement:
+      case index_assert_statement:
+      case index_check_argument:
+      case index_push_global_reference:
+      case index_push_local_reference:
+      case index_push_bound_reference:
+      case index_define_function:
+      case index_coalescence:
+      case index_member_access:
+      case index_push_unnamed_array:
+      case index_push_unnamed_object:
+      case index_apply_operator:
+      case index_unpack_struct_array:
+      case index_unpack_struct_object:
+      case index_define_null_variable:
+      case index_single_step_trap:
+      case index_variadic_call:
+      case index_defer_expression:
+      case index_import_call:
+      case index_declare_reference:
+      case index_initialize_reference:
+      case index_catch_expression:
+      case index_push_temporary:
+        return false;
+
+      default:
+        ASTERIA_TERMINATE((
+            "Invalid AIR node type (index `$1`)"),
+            this->index());
+    }
+  }
+
 void
 AIR_Node::
 get_variables(Variable_HashMap& staged, Variable_HashMap& temp) const
@@ -25,7 +25,9 @@ class AIR_Node
     struct S_declare_variable
       {
         Source_Location sloc;
+        uint32_t slot;
         phsh_string name;
+        bool untracked;
       };
 
     struct S_initialize_variable
@@ -45,7 +47,6 @@ class AIR_Node
       {
         cow_vector<cow_vector<AIR_Node>> code_labels;
         cow_vector<cow_vector<AIR_Node>> code_bodies;
-        cow_vector<cow_vector<phsh_string>> names_added;
       };
 
     struct S_do_while_statement
@@ -64,7 +65,9 @@ class AIR_Node
 
     struct S_for_each_statement
       {
+        uint32_t slot_key;
         phsh_string name_key;
+        uint32_t slot_mapped;
         phsh_string name_mapped;
         cow_vector<AIR_Node> code_init;
         cow_vector<AIR_Node> code_body;
@@ -83,8 +86,10 @@ class AIR_Node
         Source_Location sloc_try;
         cow_vector<AIR_Node> code_try;
         Source_Location sloc_catch;
+        uint32_t slot_except;
         phsh_string name_except;
         cow_vector<AIR_Node> code_catch;
+        bool backtrace;
       };
 
     struct S_throw_statement
@@ -120,7 +125,7 @@ class AIR_Node
       {
         Source_Location sloc;
         uint32_t depth;
-        size_t hint;
+        uint32_t slot;
         phsh_string name;
       };
 
@@ -203,7 +208,9 @@ class AIR_Node
       {
         bool immutable;
         Source_Location sloc;
+        uint32_t slot;
         phsh_string name;
+        bool untracked;
       };
 
     struct S_single_step_trap
@@ -232,12 +239,14 @@ class AIR_Node
 
     struct S_declare_reference
       {
+        uint32_t slot;
         phsh_string name;
       };
 
     struct S_initialize_reference
       {
         Source_Location sloc;
+        uint32_t slot;
         phsh_string name;
       };
 
@@ -373,6 +382,23 @@ class AIR_Node
     index() const noexcept
       { return static_cast<Index>(this->m_stor.index());  }
 
+    // These are accessors to the node, which are used by the optimizer.
+    // If the node is not of the requested type, a null pointer is returned.
+    template<typename XNodeT>
+    const XNodeT*
+    get_opt() const noexcept
+      { return this->m_stor.template ptr<XNodeT>();  }
+
+    template<typename XNodeT>
+    XNodeT*
+    mut_opt() noexcept
+      { return this->m_stor.template mut_ptr<XNodeT>();  }
+
+    // Check whether this node terminates control flow i.e. all subsequent
+    // nodes are unreachable. This is consistent with `solidify()`.
+    bool
+    is_terminator() const noexcept;
+
     // Rebind this node.
     // If this node refers to a local reference, which has been allocated in an
     // executive context now, we need to replace `*this` with a copy of it.
@@ -385,6 +411,15 @@ class AIR_Node
     bool
     solidify(AVMC_Queue& queue) const;
 
+    // Compress a sequence of IR nodes. Common sequences of nodes are fused into
+    // superinstructions. The return value indicates whether control flow may
+    // fall through the end of the sequence i.e. it is `false` if any node
+    // terminates control flow, in which case subsequent nodes are not
+    // solidified.
+    static
+    bool
+    solidify_all(AVMC_Queue& queue, const cow_vector<AIR_Node>& code);
+
     // This is necessary because the body of a closure shall not have been
     // solidified.
     void
@@ -4,25 +4,1033 @@
 #include "../precompiled.ipp"
 #include "air_optimizer.hpp"
 #include "analytic_context.hpp"
+#include "executive_context.hpp"
 #include "instantiated_function.hpp"
+#include "global_context.hpp"
+#include "variable.hpp"
+#include "runtime_error.hpp"
 #include "enums.hpp"
 #include "../compiler/statement.hpp"
 #include "../compiler/expression_unit.hpp"
+#include "../llds/avmc_queue.hpp"
+#include "../llds/reference_stack.hpp"
 #include "../utils.hpp"
 namespace asteria {
+namespace {
+
+// Call `func` with each sequence that is nested in `node`, and the number of
+// contexts that are created between `node` and the sequence. Bodies of closures
+// are only visited if `closures` is set.
+template<typename FuncT>
+void
+do_for_each_nested(AIR_Node& node, bool closures, FuncT&& func)
+  {
+    switch(node.index()) {
+      case AIR_Node::index_execute_block: {
+        auto& altr = *(node.mut_opt<AIR_Node::S_execute_block>());
+        func(altr.code_body, 1);
+        return;
+      }
+
+      case AIR_Node::index_if_statement: {
+        auto& altr = *(node.mut_opt<AIR_Node::S_if_statement>());
+        func(altr.code_true, 0);
+        func(altr.code_false, 0);
+        return;
+      }
+
+      case AIR_Node::index_switch_statement: {
+        auto& altr = *(node.mut_opt<AIR_Node::S_switch_statement>());
+        for(size_t i = 0;  i < altr.code_labels.size();  ++i)
+          func(altr.code_labels.mut(i), 0);
+        for(size_t i = 0;  i < altr.code_bodies.size();  ++i)
+          func(altr.code_bodies.mut(i), 1);
+        return;
+      }
+
+      case AIR_Node::index_do_while_statement: {
+        auto& altr = *(node.mut_opt<AIR_Node::S_do_while_statement>());
+        func(altr.code_body, 0);
+        func(altr.code_cond, 0);
+        return;
+      }
+
+      case AIR_Node::index_while_statement: {
+        auto& altr = *(node.mut_opt<AIR_Node::S_while_statement>());
+        func(altr.code_cond, 0);
+        func(altr.code_body, 0);
+        return;
+      }
+
+      case AIR_Node::index_for_each_statement: {
+        auto& altr = *(node.mut_opt<AIR_Node::S_for_each_statement>());
+        func(altr.code_init, 1);
+        func(altr.code_body, 1);
+        return;
+      }
+
+      case AIR_Node::index_for_statement: {
+        auto& altr = *(node.mut_opt<AIR_Node::S_for_statement>());
+        func(altr.code_init, 1);
+        func(altr.code_cond, 1);
+        func(altr.code_step, 1);
+        func(altr.code_body, 1);
+        return;
+      }
+
+      case AIR_Node::index_try_statement: {
+        auto& altr = *(node.mut_opt<AIR_Node::S_try_statement>());
+        func(altr.code_try, 0);
+        func(altr.code_catch, 1);
+        return;
+      }
+
+      case AIR_Node::index_define_function: {
+        auto& altr = *(node.mut_opt<AIR_Node::S_define_function>());
+        if(closures)
+          func(altr.code_body, 1);
+        return;
+      }
+
+      case AIR_Node::index_branch_expression: {
+        auto& altr = *(node.mut_opt<AIR_Node::S_branch_expression>());
+        func(altr.code_true, 0);
+        func(altr.code_false, 0);
+        return;
+      }
+
+      case AIR_Node::index_coalescence: {
+        auto& altr = *(node.mut_opt<AIR_Node::S_coalescence>());
+        func(altr.code_null, 0);
+        return;
+      }
+
+      case AIR_Node::index_defer_expression: {
+        auto& altr = *(node.mut_opt<AIR_Node::S_defer_expression>());
+        func(altr.code_body, 0);
+        return;
+      }
+
+      case AIR_Node::index_catch_expression: {
+        auto& altr = *(node.mut_opt<AIR_Node::S_catch_expression>());
+        func(altr.code_body, 0);
+        return;
+      }
+
+      case AIR_Node::index_clear_stack:
+      case AIR_Node::index_declare_variable:
+      case AIR_Node::index_initialize_variable:
+      case AIR_Node::index_throw_statement:
+      case AIR_Node::index_assert_statement:
+      case AIR_Node::index_simple_status:
+      case AIR_Node::index_check_argument:
+      case AIR_Node::index_push_global_reference:
+      case AIR_Node::index_push_local_reference:
+      case AIR_Node::index_push_bound_reference:
+      case AIR_Node::index_function_call:
+      case AIR_Node::index_member_access:
+      case AIR_Node::index_push_unnamed_array:
+      case AIR_Node::index_push_unnamed_object:
+      case AIR_Node::index_apply_operator:
+      case AIR_Node::index_unpack_struct_array:
+      case AIR_Node::index_unpack_struct_object:
+      case AIR_Node::index_define_null_variable:
+      case AIR_Node::index_single_step_trap:
+      case AIR_Node::index_variadic_call:
+      case AIR_Node::index_import_call:
+      case AIR_Node::index_declare_reference:
+      case AIR_Node::index_initialize_reference:
+      case AIR_Node::index_return_value:
+      case AIR_Node::index_push_temporary:
+        return;
+
+      default:
+        ASTERIA_TERMINATE((
+            "Invalid AIR node type (index `$1`)"),
+            node.index());
+    }
+  }
+
+// Apply `pass` to `code` and all sequences that are nested in it, from the
+// innermost to the outermost. A sequence is copied only if it is changed.
+// The number of changes is returned.
+template<typename PassT>
+size_t
+do_apply_pass(cow_vector<AIR_Node>& code, PassT&& pass)
+  {
+    size_t count = 0;
+
+    for(size_t k = 0;  k < code.size();  ++k) {
+      // Work on a copy of this node, which is a cheap one.
+      auto node = code[k];
+      size_t nchanged = 0;
+      do_for_each_nested(node, false,
+          [&](cow_vector<AIR_Node>& body, uint32_t) { nchanged += do_apply_pass(body, pass);  });
+
+      if(nchanged == 0)
+        continue;
+
+      code.mut(k) = ::std::move(node);
+      count += nchanged;
+    }
+
+    count += pass(code);
+    return count;
+  }
+
+// Get the number of operands of an operator which can be evaluated at compile
+// time. If the operator has side effects, zero is returned.
+uint32_t
+do_get_constant_arity(Xop xop) noexcept
+  {
+    switch(xop) {
+      case xop_pos:
+      case xop_neg:
+      case xop_notb:
+      case xop_notl:
+      case xop_countof:
+      case xop_typeof:
+      case xop_sqrt:
+      case xop_isnan:
+      case xop_isinf:
+      case xop_abs:
+      case xop_sign:
+      case xop_round:
+      case xop_floor:
+      case xop_ceil:
+      case xop_trunc:
+      case xop_iround:
+      case xop_ifloor:
+      case xop_iceil:
+      case xop_itrunc:
+      case xop_lzcnt:
+      case xop_tzcnt:
+      case xop_popcnt:
+        return 1;
+
+      case xop_cmp_eq:
+      case xop_cmp_ne:
+      case xop_cmp_lt:
+      case xop_cmp_gt:
+      case xop_cmp_lte:
+      case xop_cmp_gte:
+      case xop_cmp_3way:
+      case xop_cmp_un:
+      case xop_add:
+      case xop_sub:
+      case xop_mul:
+      case xop_div:
+      case xop_mod:
+      case xop_sll:
+      case xop_srl:
+      case xop_sla:
+      case xop_sra:
+      case xop_andb:
+      case xop_orb:
+      case xop_xorb:
+      case xop_addm:
+      case xop_subm:
+      case xop_mulm:
+      case xop_adds:
+      case xop_subs:
+      case xop_muls:
+        return 2;
+
+      case xop_fma:
+        return 3;
+
+      case xop_inc_post:
+      case xop_dec_post:
+      case xop_subscr:
+      case xop_inc_pre:
+      case xop_dec_pre:
+      case xop_unset:
+      case xop_assign:
+      case xop_head:
+      case xop_tail:
+      case xop_random:
+        return 0;
+
+      default:
+        ASTERIA_TERMINATE((
+            "Invalid operator type (xop `$1`)"),
+            xop);
+    }
+  }
+
+bool
+do_evaluate_constant(Value& result, Global_Context& global,
+                     const cow_vector<AIR_Node>& code, size_t offset, size_t count)
+  {
+    // Solidify these nodes.
+    AVMC_Queue queue;
+    for(size_t k = offset;  k != offset + count;  ++k)
+      code[k].solidify(queue);
+    queue.finalize();
+
+    // Execute them in a scratch context.
+    Reference_Stack stack, alt_stack;
+    Executive_Context ctx(Executive_Context::M_defer(), global, stack, alt_stack,
+                          cow_bivector<Source_Location, AVMC_Queue>());
+    try {
+      auto status = queue.execute(ctx);
+      ROCKET_ASSERT(status == air_status_next);
+      result = stack.top().dereference_readonly();
+    }
+    catch(Runtime_Error& /*except*/) {
+      // Leave the error to runtime, where it can be caught or reported with
+      // a backtrace.
+      return false;
+    }
+
+    // Don't create long strings which don't exist in source code, such as
+    // repeated ones from `"x" * 10000`.
+    if(result.is_string()) {
+      size_t nchars = 0;
+      for(size_t k = offset;  k != offset + count;  ++k)
+        if(auto qtemp = code[k].get_opt<AIR_Node::S_push_temporary>())
+          if(qtemp->value.is_string())
+            nchars += qtemp->value.as_string().size();
+
+      if(result.as_string().size() > ::rocket::max(nchars, size_t(1024)))
+        return false;
+    }
+    return true;
+  }
+
+size_t
+do_fold_constants(cow_vector<AIR_Node>& code, Global_Context& global)
+  {
+    size_t count = 0;
+    size_t k = 0;
+
+    while(k < code.size()) {
+      // A constant is always dereferenceable, so checking it is a no-op.
+      if((k != 0) && (code[k].index() == AIR_Node::index_check_argument)
+                  && (code[k - 1].index() == AIR_Node::index_push_temporary)) {
+        code.erase(k, 1);
+        count ++;
+        continue;
+      }
+
+      // Look for a non-assigning operator whose operands are all constants.
+      auto qxop = code[k].get_opt<AIR_Node::S_apply_operator>();
+      uint32_t nops = (qxop && !qxop->assign) ? do_get_constant_arity(qxop->xop) : 0;
+      if((nops == 0) || (k < nops)) {
+        k ++;
+        continue;
+      }
+
+      size_t offset = k - nops;
+      bool consts = ::std::all_of(code.begin() + static_cast<ptrdiff_t>(offset),
+                                  code.begin() + static_cast<ptrdiff_t>(k),
+          [](const AIR_Node& node) { return node.index() == AIR_Node::index_push_temporary;  });
+
+      Value result;
+      if(!consts || !do_evaluate_constant(result, global, code, offset, nops + 1)) {
+        k ++;
+        continue;
+      }
+
+      // Replace operands and the operator with the result. The result may
+      // be an operand of a subsequent operator.
+      AIR_Node::S_push_temporary xnode = { ::std::move(result) };
+      code.erase(offset + 1, nops);
+      code.mut(offset) = ::std::move(xnode);
+      k = offset + 1;
+      count ++;
+    }
+    return count;
+  }
+
+size_t
+do_bind_library_members(cow_vector<AIR_Node>& code, Global_Context& global)
+  {
+    // The standard library can only be bound if `std` still refers to the
+    // immutable variable that has been created by the global context.
+    auto vstd = global.std_variable();
+    auto qstd = global.get_named_reference_opt(sref("std"));
+    if(!vstd || (vstd->state() != Variable::state_immutable) || !qstd
+       || (qstd->get_variable_opt() != vstd))
+      return 0;
+
+    size_t count = 0;
+    size_t k = 0;
+
+    while(k < code.size()) {
+      // Look for `std` followed by member accesses. If `std` has been shadowed
+      // by a local name, a local reference will have been generated instead.
+      auto qglob = code[k].get_opt<AIR_Node::S_push_global_reference>();
+      if(!qglob || (qglob->name != sref("std"))) {
+        k ++;
+        continue;
+      }
+
+      // Resolve as many members as possible.
+      const Value* qparent = nullptr;
+      const Value* qval = &(vstd->get_value());
+      size_t nmembs = 0;
+
+      while(k + nmembs + 1 < code.size()) {
+        auto qmemb = code[k + nmembs + 1].get_opt<AIR_Node::S_member_access>();
+        if(!qmemb || !qval->is_object())
+          break;
+
+        auto qchild = qval->as_object().ptr(qmemb->name);
+        if(!qchild)
+          break;
+
+        qparent = qval;
+        qval = qchild;
+        nmembs ++;
+      }
+
+      // Only functions are bound. Other members are still accessed through
+      // `std`, as they may be assigned or have references bound to them, which
+      // would fail if they were temporaries.
+      if((nmembs == 0) || !qval->is_function()) {
+        k ++;
+        continue;
+      }
+
+      // A function is pushed as a member of its parent object, which becomes
+      // the `this` reference if it is called, just like before.
+      auto name = code[k + nmembs].get_opt<AIR_Node::S_member_access>()->name;
+      AIR_Node::S_push_bound_reference xnode;
+      xnode.ref.set_temporary(*qparent);
+      xnode.ref.push_modifier_object_key(name);
+      code.mut(k) = ::std::move(xnode);
+      code.erase(k + 1, nmembs);
+      k ++;
+      count ++;
+    }
+    return count;
+  }
+
+size_t
+do_prune_branches(cow_vector<AIR_Node>& code)
+  {
+    size_t count = 0;
+    size_t k = 1;
+
+    while(k < code.size()) {
+      // Look for an `if` statement whose condition is a constant.
+      auto qif = code[k].get_opt<AIR_Node::S_if_statement>();
+      auto qcond = code[k - 1].get_opt<AIR_Node::S_push_temporary>();
+      if(!qif || !qcond) {
+        k ++;
+        continue;
+      }
+
+      // Replace the condition and the statement with the branch that will
+      // be taken. If the branch needs a scope, it has been marked with a
+      // block node already.
+      bool taken = qcond->value.test() != qif->negative;
+      auto branch = taken ? qif->code_true : qif->code_false;
+      code.erase(k - 1, 2);
+      code.insert(k - 1, branch.move_begin(), branch.move_end());
+      count ++;
+    }
+    return count;
+  }
+
+size_t
+do_remove_unreachable(cow_vector<AIR_Node>& code)
+  {
+    // Find the first node that terminates control flow.
+    size_t k = 0;
+    while((k < code.size()) && !code[k].is_terminator())
+      k ++;
+
+    if(k + 1 >= code.size())
+      return 0;
+
+    // All nodes after it are unreachable.
+    size_t count = code.size() - k - 1;
+    code.erase(k + 1);
+    return count;
+  }
+
+void
+do_redirect_captures(cow_vector<AIR_Node>& code, uint32_t level,
+                     cow_vector<AIR_Node::S_push_local_reference>& captures)
+  {
+    // Redirect local references which refer to contexts outside `level` to the
+    // capture context, which is the parent of the function context.
+    for(size_t k = 0;  k < code.size();  ++k) {
+      auto qref = code[k].get_opt<AIR_Node::S_push_local_reference>();
+      if(qref && (qref->depth > level)) {
+        // Make the depth relative to the context where the closure is defined.
+        // A reference that is mentioned more than once is captured only once.
+        AIR_Node::S_push_local_reference capt = *qref;
+        capt.depth = qref->depth - level - 1;
+
+        uint32_t index = 0;
+        while((index != captures.size()) && ((captures[index].depth != capt.depth)
+                  || (captures[index].slot != capt.slot) || (captures[index].name != capt.name)))
+          index ++;
+
+        if(index == captures.size())
+          captures.emplace_back(::std::move(capt));
+
+        auto& xref = *(code.mut(k).mut_opt<AIR_Node::S_push_local_reference>());
+        xref.depth = level + 1;
+        xref.slot = index;
+      }
+
+      do_for_each_nested(code.mut(k), true,
+          [&](cow_vector<AIR_Node>& body, uint32_t n) { do_redirect_captures(body, level + n, captures);  });
+    }
+  }
+
+// These are variables that a reference on the stack may denote. Each of them
+// is identified by its context and frame slot. IDs are kept sorted, so they
+// can be found with binary search.
+using Escape_Taint = cow_vector<uint64_t>;
+
+struct Escape_State
+  {
+    cow_vector<uint32_t> ctxs;     // IDs of enclosing contexts, innermost last
+    uint32_t next_ctx = 0;
+    size_t nouter = 0;             // number of contexts outside the closure being
+                                   // visited, or zero if not in a closure
+    Escape_Taint escaped;          // variables whose references may escape
+  };
+
+uint64_t
+do_make_variable_id(uint32_t ctx, uint32_t slot) noexcept
+  {
+    return (uint64_t) ctx << 32 | slot;
+  }
+
+bool
+do_find_variable_id(const Escape_Taint& taint, uint64_t id) noexcept
+  {
+    return ::std::binary_search(taint.begin(), taint.end(), id);
+  }
+
+void
+do_merge_taints(Escape_Taint& taint, const Escape_Taint& other)
+  {
+    // As `other` is also sorted, each ID is searched after the previous one.
+    size_t start = 0;
+    for(uint64_t id : other) {
+      auto pos = ::std::lower_bound(taint.begin() + static_cast<ptrdiff_t>(start),
+                                    taint.end(), id);
+      start = static_cast<size_t>(pos - taint.begin());
+      if((pos == taint.end()) || (*pos != id))
+        taint.insert(start, id);
+      start ++;
+    }
+  }
+
+void
+do_escape_taint(Escape_State& st, const Escape_Taint& taint)
+  {
+    do_merge_taints(st.escaped, taint);
+  }
+
+Escape_Taint
+do_pop_taints(cow_vector<Escape_Taint>& stack, size_t count)
+  {
+    // References that have been pushed outside the sequence being visited
+    // are unknown, and are assumed to denote no local variable.
+    Escape_Taint taint;
+    while(count && !stack.empty()) {
+      do_merge_taints(taint, stack.back());
+      stack.pop_back();
+      count --;
+    }
+    return taint;
+  }
+
+// Get the number of operands of an operator, and whether its result is the
+// reference to its first operand.
+uint32_t
+do_get_operator_arity(bool& forwards, Xop xop) noexcept
+  {
+    switch(xop) {
+      case xop_inc_post:
+      case xop_dec_post:
+      case xop_pos:
+      case xop_neg:
+      case xop_notb:
+      case xop_notl:
+      case xop_unset:
+      case xop_countof:
+      case xop_typeof:
+      case xop_sqrt:
+      case xop_isnan:
+      case xop_isinf:
+      case xop_abs:
+      case xop_sign:
+      case xop_round:
+      case xop_floor:
+      case xop_ceil:
+      case xop_trunc:
+      case xop_iround:
+      case xop_ifloor:
+      case xop_iceil:
+      case xop_itrunc:
+      case xop_lzcnt:
+      case xop_tzcnt:
+      case xop_popcnt:
+        return 1;
+
+      case xop_inc_pre:
+      case xop_dec_pre:
+      case xop_head:
+      case xop_tail:
+      case xop_random:
+        forwards = true;
+        return 1;
+
+      case xop_cmp_eq:
+      case xop_cmp_ne:
+      case xop_cmp_lt:
+      case xop_cmp_gt:
+      case xop_cmp_lte:
+      case xop_cmp_gte:
+      case xop_cmp_3way:
+      case xop_cmp_un:
+      case xop_add:
+      case xop_sub:
+      case xop_mul:
+      case xop_div:
+      case xop_mod:
+      case xop_sll:
+      case xop_srl:
+      case xop_sla:
+      case xop_sra:
+      case xop_andb:
+      case xop_orb:
+      case xop_xorb:
+      case xop_addm:
+      case xop_subm:
+      case xop_mulm:
+      case xop_adds:
+      case xop_subs:
+      case xop_muls:
+        return 2;
+
+      case xop_subscr:
+      case xop_assign:
+        forwards = true;
+        return 2;
+
+      case xop_fma:
+        return 3;
+
+      default:
+        ASTERIA_TERMINATE((
+            "Invalid operator type (xop `$1`)"),
+            xop);
+    }
+  }
+
+// Mark declarations of variables in the context `ctx` which don't escape. The
+// context may span sequences that don't create contexts of their own, so they
+// are visited, too.
+size_t
+do_mark_untracked(cow_vector<AIR_Node>& code, uint32_t ctx, const Escape_Taint& escaped)
+  {
+    size_t count = 0;
+
+    for(size_t k = 0;  k < code.size();  ++k) {
+      // Work on a copy of this node, which is a cheap one.
+      auto node = code[k];
+      size_t nchanged = 0;
+
+      if(auto qdecl = node.mut_opt<AIR_Node::S_declare_variable>())
+        if(!qdecl->untracked && !do_find_variable_id(escaped, do_make_variable_id(ctx, qdecl->slot)))
+          nchanged += (qdecl->untracked = true);
+
+      if(auto qdecl = node.mut_opt<AIR_Node::S_define_null_variable>())
+        if(!qdecl->untracked && !do_find_variable_id(escaped, do_make_variable_id(ctx, qdecl->slot)))
+          nchanged += (qdecl->untracked = true);
+
+      do_for_each_nested(node, false,
+          [&](cow_vector<AIR_Node>& body, uint32_t n) {
+            if(n == 0)
+              nchanged += do_mark_untracked(body, ctx, escaped);
+          });
+
+      if(nchanged == 0)
+        continue;
+
+      code.mut(k) = ::std::move(node);
+      count += nchanged;
+    }
+    return count;
+  }
+
+size_t
+do_find_escapes(Escape_State& st, cow_vector<Escape_Taint>& stack, cow_vector<AIR_Node>& code);
+
+// Visit a sequence that is nested in a node on a copy of the stack, and return
+// the taint of its result.
+Escape_Taint
+do_find_nested_escapes(size_t& count, Escape_State& st, const cow_vector<Escape_Taint>& stack,
+                       cow_vector<AIR_Node>& body, uint32_t n, uint32_t ctx)
+  {
+    auto temp = stack;
+    if(n != 0)
+      st.ctxs.push_back(ctx);
+
+    count += do_find_escapes(st, temp, body);
+
+    if(n != 0)
+      st.ctxs.pop_back();
+    return temp.empty() ? Escape_Taint() : temp.back();
+  }
+
+// Simulate the stack, so references to local variables can be tracked. A
+// variable escapes if a reference to it is captured by a closure, passed
+// or returned by reference, or bound to a reference. Declarations of other
+// variables are marked as they are found, unless they are in closures, which
+// are handled when closures themselves are optimized.
+size_t
+do_find_escapes(Escape_State& st, cow_vector<Escape_Taint>& stack, cow_vector<AIR_Node>& code)
+  {
+    size_t count = 0;
+
+    for(size_t k = 0;  k < code.size();  ++k) {
+      // Work on a copy of this node, which is a cheap one.
+      auto node = code[k];
+      size_t nchanged = 0;
+      uint32_t ctx = st.next_ctx ++;
+
+      switch(node.index()) {
+        case AIR_Node::index_clear_stack:
+          stack.clear();
+          break;
+
+        case AIR_Node::index_execute_block:
+        case AIR_Node::index_if_statement:
+        case AIR_Node::index_switch_statement:
+        case AIR_Node::index_do_while_statement:
+        case AIR_Node::index_while_statement:
+        case AIR_Node::index_for_statement:
+        case AIR_Node::index_try_statement:
+        case AIR_Node::index_defer_expression:
+          do_for_each_nested(node, false,
+              [&](cow_vector<AIR_Node>& body, uint32_t n) {
+                do_find_nested_escapes(nchanged, st, stack, body, n, ctx);
+              });
+          break;
+
+        case AIR_Node::index_for_each_statement: {
+          // The range is bound to the mapped reference.
+          auto& altr = *(node.mut_opt<AIR_Node::S_for_each_statement>());
+          do_escape_taint(st, do_find_nested_escapes(nchanged, st, stack, altr.code_init, 1, ctx));
+          do_find_nested_escapes(nchanged, st, stack, altr.code_body, 1, ctx);
+          break;
+        }
+
+        case AIR_Node::index_declare_variable: {
+          const auto& altr = *(node.get_opt<AIR_Node::S_declare_variable>());
+          stack.emplace_back().emplace_back(do_make_variable_id(st.ctxs.back(), altr.slot));
+          break;
+        }
+
+        case AIR_Node::index_initialize_variable:
+          do_pop_taints(stack, 2);
+          break;
+
+        case AIR_Node::index_unpack_struct_array: {
+          const auto& altr = *(node.get_opt<AIR_Node::S_unpack_struct_array>());
+          do_pop_taints(stack, 1 + altr.nelems);
+          break;
+        }
+
+        case AIR_Node::index_unpack_struct_object: {
+          const auto& altr = *(node.get_opt<AIR_Node::S_unpack_struct_object>());
+          do_pop_taints(stack, 1 + altr.keys.size());
+          break;
+        }
+
+        case AIR_Node::index_simple_status: {
+          const auto& altr = *(node.get_opt<AIR_Node::S_simple_status>());
+          if((altr.status == air_status_return_ref) && !stack.empty())
+            do_escape_taint(st, stack.back());
+          break;
+        }
+
+        case AIR_Node::index_check_argument: {
+          const auto& altr = *(node.get_opt<AIR_Node::S_check_argument>());
+          if(stack.empty())
+            break;
+
+          if(altr.by_ref)
+            do_escape_taint(st, stack.back());
+          else
+            stack.mut_back().clear();
+          break;
+        }
+
+        case AIR_Node::index_return_value:
+          if(!stack.empty())
+            stack.mut_back().clear();
+          break;
+
+        case AIR_Node::index_push_global_reference:
+        case AIR_Node::index_push_bound_reference:
+        case AIR_Node::index_push_temporary:
+          stack.emplace_back();
+          break;
+
+        case AIR_Node::index_push_local_reference: {
+          const auto& altr = *(node.get_opt<AIR_Node::S_push_local_reference>());
+          auto& taint = stack.emplace_back();
+
+          // Ignore references outside this function, as well as pre-defined
+          // ones which have no slots.
+          if((altr.depth >= st.ctxs.size()) || (altr.slot == UINT32_MAX))
+            break;
+
+          size_t index = st.ctxs.size() - 1 - altr.depth;
+          taint.emplace_back(do_make_variable_id(st.ctxs[index], altr.slot));
+
+          // If the variable is outside the closure, it is captured.
+          if(index < st.nouter)
+            do_escape_taint(st, taint);
+          break;
+        }
+
+        case AIR_Node::index_define_function: {
+          const auto& altr = *(node.get_opt<AIR_Node::S_define_function>());
+          stack.emplace_back();
+
+          // Visit the body on a copy, which is not to be rewritten.
+          auto body = altr.code_body;
+          cow_vector<Escape_Taint> temp;
+          size_t old_nouter = st.nouter;
+          if(old_nouter == 0)
+            st.nouter = st.ctxs.size();
+
+          st.ctxs.push_back(ctx);
+          do_find_escapes(st, temp, body);
+          st.ctxs.pop_back();
+          st.nouter = old_nouter;
+          break;
+        }
+
+        case AIR_Node::index_branch_expression: {
+          auto& altr = *(node.mut_opt<AIR_Node::S_branch_expression>());
+          auto taint = do_pop_taints(stack, 1);
+          stack.emplace_back(taint);
+          do_merge_taints(taint, do_find_nested_escapes(nchanged, st, stack, altr.code_true, 0, ctx));
+          do_merge_taints(taint, do_find_nested_escapes(nchanged, st, stack, altr.code_false, 0, ctx));
+          stack.mut_back() = ::std::move(taint);
+          break;
+        }
+
+        case AIR_Node::index_coalescence: {
+          auto& altr = *(node.mut_opt<AIR_Node::S_coalescence>());
+          auto taint = do_pop_taints(stack, 1);
+          stack.emplace_back(taint);
+          do_merge_taints(taint, do_find_nested_escapes(nchanged, st, stack, altr.code_null, 0, ctx));
+          stack.mut_back() = ::std::move(taint);
+          break;
+        }
+
+        case AIR_Node::index_catch_expression: {
+          auto& altr = *(node.mut_opt<AIR_Node::S_catch_expression>());
+          do_find_nested_escapes(nchanged, st, stack, altr.code_body, 0, ctx);
+          stack.emplace_back();
+          break;
+        }
+
+        case AIR_Node::index_function_call: {
+          // The target may be called with its `this` reference.
+          const auto& altr = *(node.get_opt<AIR_Node::S_function_call>());
+          do_escape_taint(st, do_pop_taints(stack, 1 + altr.nargs));
+          stack.emplace_back();
+          break;
+        }
+
+        case AIR_Node::index_variadic_call:
+          do_escape_taint(st, do_pop_taints(stack, 2));
+          stack.emplace_back();
+          break;
+
+        case AIR_Node::index_import_call: {
+          const auto& altr = *(node.get_opt<AIR_Node::S_import_call>());
+          do_escape_taint(st, do_pop_taints(stack, altr.nargs));
+          stack.emplace_back();
+          break;
+        }
+
+        case AIR_Node::index_push_unnamed_array: {
+          const auto& altr = *(node.get_opt<AIR_Node::S_push_unnamed_array>());
+          do_pop_taints(stack, altr.nelems);
+          stack.emplace_back();
+          break;
+        }
+
+        case AIR_Node::index_push_unnamed_object: {
+          const auto& altr = *(node.get_opt<AIR_Node::S_push_unnamed_object>());
+          do_pop_taints(stack, altr.keys.size());
+          stack.emplace_back();
+          break;
+        }
+
+        case AIR_Node::index_apply_operator: {
+          // Compound assignment operators also yield their first operands.
+          const auto& altr = *(node.get_opt<AIR_Node::S_apply_operator>());
+          bool forwards = altr.assign;
+          uint32_t nops = do_get_operator_arity(forwards, altr.xop);
+          auto taint = do_pop_taints(stack, nops);
+          stack.emplace_back(forwards ? ::std::move(taint) : Escape_Taint());
+          break;
+        }
+
+        case AIR_Node::index_initialize_reference:
+          do_escape_taint(st, do_pop_taints(stack, 1));
+          break;
+
+        case AIR_Node::index_throw_statement:
+        case AIR_Node::index_assert_statement:
+        case AIR_Node::index_member_access:
+        case AIR_Node::index_define_null_variable:
+        case AIR_Node::index_single_step_trap:
+        case AIR_Node::index_declare_reference:
+          break;
+
+        default:
+          ASTERIA_TERMINATE((
+              "Invalid AIR node type (index `$1`)"),
+              node.index());
+      }
+
+      // All references to variables in contexts of this node have been
+      // visited, so their declarations can be marked now.
+      if(st.nouter == 0)
+        do_for_each_nested(node, false,
+            [&](cow_vector<AIR_Node>& body, uint32_t n) {
+              if(n != 0)
+                nchanged += do_mark_untracked(body, ctx, st.escaped);
+            });
+
+      if(nchanged == 0)
+        continue;
+
+      code.mut(k) = ::std::move(node);
+      count += nchanged;
+    }
+    return count;
+  }
+
+size_t
+do_untrack_locals(cow_vector<AIR_Node>& code)
+  {
+    // Start from the function context.
+    Escape_State st;
+    st.ctxs.push_back(st.next_ctx ++);
+    cow_vector<Escape_Taint> stack;
+    size_t count = do_find_escapes(st, stack, code);
+    count += do_mark_untracked(code, st.ctxs.back(), st.escaped);
+    return count;
+  }
+
+bool
+do_find_local_reference(const cow_vector<AIR_Node>& code, const phsh_string& name)
+  {
+    for(size_t k = 0;  k < code.size();  ++k) {
+      auto qaltr = code[k].get_opt<AIR_Node::S_push_local_reference>();
+      if(qaltr && (qaltr->name == name))
+        return true;
+
+      // Search nested sequences, including bodies of closures, which may
+      // capture the reference. Depths are not checked.
+      auto node = code[k];
+      bool found = false;
+      do_for_each_nested(node, true,
+          [&](cow_vector<AIR_Node>& body, uint32_t /*n*/) {
+            found = found || do_find_local_reference(body, name);
+          });
+
+      if(found)
+        return true;
+    }
+    return false;
+  }
+
+// Backtraces are converted to arrays of objects when exceptions are caught,
+// which are expensive. If a `catch` clause doesn't reference `__backtrace`
+// anywhere, the conversion is skipped.
+size_t
+do_elide_backtraces(cow_vector<AIR_Node>& code)
+  {
+    size_t count = 0;
+    for(size_t k = 0;  k < code.size();  ++k) {
+      auto qaltr = code[k].get_opt<AIR_Node::S_try_statement>();
+      if(!qaltr || !qaltr->backtrace)
+        continue;
+
+      if(do_find_local_reference(qaltr->code_catch, sref("__backtrace")))
+        continue;
+
+      code.mut(k).mut_opt<AIR_Node::S_try_statement>()->backtrace = false;
+      count ++;
+    }
+    return count;
+  }
+
+cow_string
+do_compose_signature(stringR name, const cow_vector<phsh_string>& params)
+  {
+    // Compose the function signature.
+    // We only do this if `name` really looks like a function name.
+    cow_string func = name;
+    if(is_cmask(name.front(), cmask_namei) && (name.back() != ')')) {
+      func << '(';
+      if(params.size()) {
+        func << params[0];
+        for(size_t k = 1;  k < params.size();  ++k)
+          func << ", " << params[k];
+      }
+      func << ')';
+    }
+    return func;
+  }
+
+}  // namespace
 
 AIR_Optimizer::
 ~AIR_Optimizer()
   {
   }
 
+void
+AIR_Optimizer::
+do_optimize(Global_Context& global)
+  {
+    // Bind functions of the standard library first. Fold constants then, which
+    // may make conditions constant. Pruned branches may end with `return` or
+    // `throw`.
+    this->m_stats.nbound = do_apply_pass(this->m_code,
+        [&](cow_vector<AIR_Node>& code) { return do_bind_library_members(code, global);  });
+
+    this->m_stats.nfolded = do_apply_pass(this->m_code,
+        [&](cow_vector<AIR_Node>& code) { return do_fold_constants(code, global);  });
+
+    this->m_stats.npruned = do_apply_pass(this->m_code, do_prune_branches);
+    this->m_stats.nremoved = do_apply_pass(this->m_code, do_remove_unreachable);
+
+    // Variables which don't escape are not tracked by the garbage collector.
+    this->m_stats.nuntracked = do_untrack_locals(this->m_code);
+    this->m_stats.nuntraced = do_apply_pass(this->m_code, do_elide_backtraces);
+  }
+
 void
 AIR_Optimizer::
 reload(Abstract_Context* ctx_opt, const cow_vector<phsh_string>& params,
-       const Global_Context& global, const cow_vector<Statement>& stmts)
+       Global_Context& global, const cow_vector<Statement>& stmts)
   {
     this->m_code.clear();
     this->m_params = params;
+    this->m_stats = { };
 
     if(stmts.empty())
       return;
@@ -32,26 +1040,27 @@ reload(Abstract_Context* ctx_opt, const cow_vector<phsh_string>& params,
 
     // Generate code for all statements.
     for(size_t k = 0;  k + 1 < stmts.size();  ++k)
-      stmts.at(k).generate_code(this->m_code, nullptr, global, ctx_func, this->m_opts,
+      stmts.at(k).generate_code(this->m_code, global, ctx_func, this->m_opts,
               stmts.at(k + 1).is_empty_return() ? ptc_aware_void : ptc_aware_none);
 
-    stmts.back().generate_code(this->m_code, nullptr, global, ctx_func, this->m_opts,
+    stmts.back().generate_code(this->m_code, global, ctx_func, this->m_opts,
             ptc_aware_void);
 
     // Check whether optimization is enabled during translation.
     if(this->m_opts.optimization_level < 2)
       return;
 
-    // TODO: Insert optimization passes
+    this->do_optimize(global);
   }
 
 void
 AIR_Optimizer::
 rebind(Abstract_Context* ctx_opt, const cow_vector<phsh_string>& params,
-       const cow_vector<AIR_Node>& code)
+       Global_Context& global, const cow_vector<AIR_Node>& code)
   {
     this->m_code = code;
     this->m_params = params;
+    this->m_stats = { };
 
     if(code.empty())
       return;
@@ -70,29 +1079,40 @@ rebind(Abstract_Context* ctx_opt, const cow_vector<phsh_string>& params,
     if(this->m_opts.optimization_level < 3)
       return;
 
-    // TODO: Insert optimization passes
+    this->do_optimize(global);
+  }
+
+void
+AIR_Optimizer::
+share(const cow_vector<phsh_string>& params, const cow_vector<AIR_Node>& code,
+      cow_vector<AIR_Node::S_push_local_reference>& captures)
+  {
+    this->m_code = code;
+    this->m_params = params;
+    this->m_stats = { };
+
+    // The function context is the outermost one, and its parent is the
+    // capture context.
+    captures.clear();
+    do_redirect_captures(this->m_code, 0, captures);
   }
 
 cow_function
 AIR_Optimizer::
 create_function(const Source_Location& sloc, stringR name)
   {
-    // Compose the function signature.
-    // We only do this if `name` really looks like a function name.
-    cow_string func = name;
-    if(is_cmask(name.front(), cmask_namei) && (name.back() != ')')) {
-      func << '(';
-      if(this->m_params.size()) {
-        func << this->m_params[0];
-        for(size_t k = 1;  k < this->m_params.size();  ++k)
-          func << ", " << this->m_params[k];
-      }
-      func << ')';
-    }
+    return this->create_prototype(sloc, name);
+  }
 
-    // Instantiate the function.
-    return ::rocket::make_refcnt<Instantiated_Function>(this->m_params,
-               ::rocket::make_refcnt<Variadic_Arguer>(sloc, ::std::move(func)),
+refcnt_ptr<const Instantiated_Function>
+AIR_Optimizer::
+create_prototype(const Source_Location& sloc, stringR name)
+  {
+    // Instantiate the function. Closures will share it, and will only add
+    // their captured references.
+    return ::rocket::make_refcnt<Instantiated_Function>(this->m_opts, this->m_params,
+               ::rocket::make_refcnt<Variadic_Arguer>(sloc,
+                      do_compose_signature(name, this->m_params)),
                this->m_code);
   }
 
@@ -10,10 +10,28 @@ namespace asteria {
 
 class AIR_Optimizer
   {
+  public:
+    // These are numbers of changes that have been made by each pass, so the
+    // effect of optimization can be measured.
+    struct Statistics
+      {
+        size_t nbound;      // functions of the standard library bound
+        size_t nfolded;     // constant expressions folded
+        size_t npruned;     // `if` statements with constant conditions pruned
+        size_t nremoved;    // unreachable nodes removed
+        size_t nuntracked;  // local variables that need no garbage collection
+        size_t nuntraced;   // `catch` clauses that need no `__backtrace`
+      };
+
   private:
     Compiler_Options m_opts;
     cow_vector<phsh_string> m_params;
     cow_vector<AIR_Node> m_code;
+    Statistics m_stats = { };
+
+  private:
+    void
+    do_optimize(Global_Context& global);
 
   public:
     explicit constexpr
@@ -49,21 +67,40 @@ class AIR_Optimizer
     clear() noexcept
       { this->m_code.clear();  }
 
+    // These are statistics of the last call to `reload()` or `rebind()`.
+    const Statistics&
+    get_statistics() const noexcept
+      { return this->m_stats;  }
+
     // This function performs code generation.
     // `ctx_opt` is the parent context of this closure.
     void
     reload(Abstract_Context* ctx_opt, const cow_vector<phsh_string>& params,
-           const Global_Context& global, const cow_vector<Statement>& stmts);
+           Global_Context& global, const cow_vector<Statement>& stmts);
 
     // This function loads some already-generated code.
     // `ctx_opt` is the parent context of this closure.
     void
     rebind(Abstract_Context* ctx_opt, const cow_vector<phsh_string>& params,
-           const cow_vector<AIR_Node>& code);
+           Global_Context& global, const cow_vector<AIR_Node>& code);
+
+    // This function loads some already-generated code, which will be shared
+    // by all closures that are created from the same definition. References
+    // to contexts outside the function are redirected to the capture context,
+    // and their sources are stored into `captures`.
+    void
+    share(const cow_vector<phsh_string>& params, const cow_vector<AIR_Node>& code,
+          cow_vector<AIR_Node::S_push_local_reference>& captures);
 
     // Create a closure value that can be assigned to a variable.
     cow_function
     create_function(const Source_Location& sloc, stringR name);
+
+    // Create a prototype whose code will be shared by closures, which only
+    // add their captured references. This shall be called after `share()`.
+    // `create_function()` returns the same object as a closure value.
+    refcnt_ptr<const Instantiated_Function>
+    create_prototype(const Source_Location& sloc, stringR name);
   };
 
 }  // namespace asteria
@@ -11,7 +11,10 @@ Analytic_Context(M_function, Abstract_Context* parent_opt,
                  const cow_vector<phsh_string>& params)
   : m_parent_opt(parent_opt)
   {
-    // Set parameters, which are local references.
+    // Set parameters, which are local references. The i-th parameter is
+    // always assigned the i-th slot, even if its name is duplicate.
+    // N.B. If you have ever changed this, remember to update
+    // 'executive_context.cpp' as well.
     for(const auto& name : params) {
       // Nothing is set for the variadic placeholder, but the parameter
       // list terminates here.
@@ -20,6 +23,7 @@ Analytic_Context(M_function, Abstract_Context* parent_opt,
 
       // Its contents are out of interest.
       this->do_open_named_reference(nullptr, name).set_invalid();
+      this->m_slots.insert_or_assign(name, this->m_nslots++);
     }
 
     // Set pre-defined references.
@@ -35,4 +39,19 @@ Analytic_Context::
   {
   }
 
+uint32_t
+Analytic_Context::
+declare_local(phsh_stringR name)
+  {
+    // Just ensure the name exists. Its contents are out of interest.
+    this->do_open_named_reference(nullptr, name).set_invalid();
+
+    // If the name exists, reuse its slot, so the old reference will be
+    // replaced by the new one.
+    auto result = this->m_slots.try_emplace(name, this->m_nslots);
+    if(result.second)
+      this->m_nslots++;
+    return result.first->second;
+  }
+
 }  // namespace asteria
@@ -14,6 +14,11 @@ class Analytic_Context
   private:
     Abstract_Context* m_parent_opt;
 
+    // Local references are assigned frame slots at compile time, so they can
+    // be accessed by index at runtime.
+    cow_dictionary<uint32_t> m_slots;
+    uint32_t m_nslots = 0;
+
   public:
     // A plain context must have a parent context.
     // Its parent context shall outlast itself.
@@ -51,6 +56,25 @@ class Analytic_Context
     Abstract_Context*
     get_parent_opt() const noexcept
       { return this->m_parent_opt;  }
+
+    uint32_t
+    count_slots() const noexcept
+      { return this->m_nslots;  }
+
+    // Declare a local reference and return its frame slot. If the name has
+    // been declared in this context, its slot is reused.
+    uint32_t
+    declare_local(phsh_stringR name);
+
+    // Get the frame slot of a local reference. `UINT32_MAX` is returned if
+    // the name has not been declared, or if it denotes a pre-defined
+    // reference, which is always looked up by name.
+    uint32_t
+    find_local_slot(phsh_stringR name) const
+      {
+        auto qslot = this->m_slots.ptr(name);
+        return qslot ? *qslot : UINT32_MAX;
+      }
   };
 
 }  // namespace asteria
@@ -0,0 +1,141 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2022, LH_Mouse. All wrongs reserved.
+
+#include "../precompiled.ipp"
+#include "call_pool.hpp"
+#include "ptc_arguments.hpp"
+#include "../utils.hpp"
+namespace asteria {
+namespace {
+
+// These limit the amount of memory that is kept for reuse. Stacks are
+// needed by each level of nested calls, while proper tail calls need
+// only a few objects.
+constexpr size_t max_pooled_stacks = 64;
+constexpr size_t max_pooled_stack_bytes = 16384;
+constexpr size_t max_pooled_slots = 64;
+constexpr size_t max_pooled_ptcas = 16;
+
+}  // namespace
+
+Call_Pool::
+~Call_Pool()
+  {
+  }
+
+void
+Call_Pool::
+clear() noexcept
+  {
+    this->m_stacks.clear();
+    this->m_slots.clear();
+    this->m_ptcas.clear();
+  }
+
+Reference_Stack
+Call_Pool::
+allocate_stack() noexcept
+  {
+    Reference_Stack stack;
+    if(this->m_stacks.empty())
+      return stack;
+
+    stack.swap(this->m_stacks.mut_back());
+    this->m_stacks.pop_back();
+    return stack;
+  }
+
+void
+Call_Pool::
+recycle_stack(Reference_Stack&& stack) noexcept
+  {
+    // Destroy all references first, as this may release other stacks.
+    stack.clear();
+    stack.clear_cache();
+
+    // A deep recursion may have left a huge stack behind, which shouldn't
+    // be kept around.
+    if((stack.capacity() == 0) || (this->m_stacks.size() >= max_pooled_stacks))
+      return;
+
+    if(stack.capacity() > max_pooled_stack_bytes / sizeof(Reference))
+      return;
+
+    try {
+      this->m_stacks.emplace_back(::std::move(stack));
+    }
+    catch(::std::exception&) {
+      // Let the stack go.
+    }
+  }
+
+cow_vector<Reference>
+Call_Pool::
+allocate_slots() noexcept
+  {
+    cow_vector<Reference> slots;
+    if(this->m_slots.empty())
+      return slots;
+
+    slots.swap(this->m_slots.mut_back());
+    this->m_slots.pop_back();
+    return slots;
+  }
+
+void
+Call_Pool::
+recycle_slots(cow_vector<Reference>&& slots) noexcept
+  {
+    // Destroy all references first, as this may release other vectors.
+    slots.clear();
+
+    if((slots.capacity() == 0) || (this->m_slots.size() >= max_pooled_slots))
+      return;
+
+    try {
+      this->m_slots.emplace_back(::std::move(slots));
+    }
+    catch(::std::exception&) {
+      // Let the vector go.
+    }
+  }
+
+refcnt_ptr<PTC_Arguments>
+Call_Pool::
+allocate_ptc_arguments(const Source_Location& sloc, PTC_Aware ptc,
+                       const cow_function& target, Reference_Stack&& stack)
+  {
+    if(this->m_ptcas.empty())
+      return ::rocket::make_refcnt<PTC_Arguments>(sloc, ptc, target, ::std::move(stack));
+
+    // Reuse an object. Its stack is cleared, and is swapped with `stack`,
+    // so the storage is recycled, too.
+    auto ptca = ::std::move(this->m_ptcas.mut_back());
+    this->m_ptcas.pop_back();
+    ptca->reset(sloc, ptc, target, stack);
+    return ptca;
+  }
+
+void
+Call_Pool::
+recycle_ptc_arguments(refcnt_ptr<PTC_Arguments>&& ptca_in) noexcept
+  {
+    auto ptca = ::std::move(ptca_in);
+    if(!ptca || (ptca.use_count() != 1))
+      return;
+
+    // Destroy all references first, as this may release other objects.
+    ptca->clear();
+
+    if(this->m_ptcas.size() >= max_pooled_ptcas)
+      return;
+
+    try {
+      this->m_ptcas.emplace_back(::std::move(ptca));
+    }
+    catch(::std::exception&) {
+      // Let the object go.
+    }
+  }
+
+}  // namespace asteria
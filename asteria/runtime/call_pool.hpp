@@ -0,0 +1,104 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2022, LH_Mouse. All wrongs reserved.
+
+#ifndef ASTERIA_RUNTIME_CALL_POOL_
+#define ASTERIA_RUNTIME_CALL_POOL_
+
+#include "../fwd.hpp"
+#include "../llds/reference_stack.hpp"
+namespace asteria {
+
+class Call_Pool final
+  : public rcfwd<Call_Pool>
+  {
+  public:
+    class Unique_Stack;  // RAII wrapper
+
+  private:
+    // These are recycled storage for function calls, so calls in a steady
+    // state do not allocate memory. Each of them is empty.
+    cow_vector<Reference_Stack> m_stacks;
+    cow_vector<cow_vector<Reference>> m_slots;
+    cow_vector<refcnt_ptr<PTC_Arguments>> m_ptcas;
+
+  public:
+    explicit
+    Call_Pool() noexcept
+      { }
+
+  public:
+    ASTERIA_NONCOPYABLE_DESTRUCTOR(Call_Pool);
+
+    size_t
+    count_pooled_stacks() const noexcept
+      { return this->m_stacks.size();  }
+
+    size_t
+    count_pooled_slots() const noexcept
+      { return this->m_slots.size();  }
+
+    size_t
+    count_pooled_ptc_arguments() const noexcept
+      { return this->m_ptcas.size();  }
+
+    void
+    clear() noexcept;
+
+    // Gets an empty stack, which may have been recycled.
+    Reference_Stack
+    allocate_stack() noexcept;
+
+    // Clears a stack and recycles its storage. Large stacks are freed.
+    void
+    recycle_stack(Reference_Stack&& stack) noexcept;
+
+    // Gets an empty vector for frame slots, which may have been recycled.
+    cow_vector<Reference>
+    allocate_slots() noexcept;
+
+    // Clears frame slots and recycles their storage.
+    void
+    recycle_slots(cow_vector<Reference>&& slots) noexcept;
+
+    // Packs arguments for a proper tail call, which may reuse a recycled
+    // object. The contents of `stack` are moved into it, and `stack` is
+    // left empty.
+    refcnt_ptr<PTC_Arguments>
+    allocate_ptc_arguments(const Source_Location& sloc, PTC_Aware ptc,
+                           const cow_function& target, Reference_Stack&& stack);
+
+    // Clears arguments for a proper tail call and recycles the object, if
+    // there is no other reference to it.
+    void
+    recycle_ptc_arguments(refcnt_ptr<PTC_Arguments>&& ptca) noexcept;
+  };
+
+class Call_Pool::Unique_Stack
+  {
+  private:
+    Call_Pool* m_pool;  // owned by the global context
+    Reference_Stack m_stack;
+
+  public:
+    explicit
+    Unique_Stack(Call_Pool& pool) noexcept
+      : m_pool(&pool), m_stack(pool.allocate_stack())
+      { }
+
+    Unique_Stack(const Unique_Stack&) = delete;
+    Unique_Stack& operator=(const Unique_Stack&) = delete;
+
+    ~Unique_Stack()
+      { this->m_pool->recycle_stack(::std::move(this->m_stack));  }
+
+    const Reference_Stack&
+    get() const noexcept
+      { return this->m_stack;  }
+
+    Reference_Stack&
+    get() noexcept
+      { return this->m_stack;  }
+  };
+
+}  // namespace asteria
+#endif
@@ -6,6 +6,8 @@
 #include "runtime_error.hpp"
 #include "../runtime/runtime_error.hpp"
 #include "ptc_arguments.hpp"
+#include "call_pool.hpp"
+#include "global_context.hpp"
 #include "enums.hpp"
 #include "variable.hpp"
 #include "../llds/avmc_queue.hpp"
@@ -15,11 +17,13 @@ namespace asteria {
 
 ROCKET_FLATTEN
 Executive_Context::
-Executive_Context(M_function, Global_Context& global, Reference_Stack& stack,
+Executive_Context(M_function, Executive_Context* parent_opt,
+                  Global_Context& global, Reference_Stack& stack,
                   Reference_Stack& alt_stack, const refcnt_ptr<Variadic_Arguer>& zvarg,
                   const cow_vector<phsh_string>& params, Reference&& self)
-  : m_parent_opt(),
+  : m_parent_opt(parent_opt),
     m_global(&global), m_stack(&stack), m_alt_stack(&alt_stack),
+    m_slots(global.call_pool().allocate_slots()),
     m_zvarg(zvarg)
   {
     // Set the `this` reference.
@@ -61,10 +65,13 @@ Executive_Context(M_function, Global_Context& global, Reference_Stack& stack,
 
       // Try popping an argument from `stack` and assign it to this parameter.
       // If no more arguments follow, declare a constant `null`.
+      // N.B. The i-th parameter is always stored in the i-th slot. If you have
+      // ever changed this, remember to update 'analytic_context.cpp' as well.
+      auto& ref = this->m_slots.emplace_back();
       if(nargs != 0)
-        this->do_open_named_reference(nullptr, name) = ::std::move(stack.mut_top(--nargs));
+        ref = ::std::move(stack.mut_top(--nargs));
       else
-        this->do_open_named_reference(nullptr, name).set_temporary(nullopt);
+        ref.set_temporary(nullopt);
     }
 
     // All arguments must have been consumed.
@@ -77,6 +84,9 @@ Executive_Context(M_function, Global_Context& global, Reference_Stack& stack,
 Executive_Context::
 ~Executive_Context()
   {
+    // Recycle frame slots of a function.
+    if(this->m_zvarg)
+      this->m_global->call_pool().recycle_slots(::std::move(this->m_slots));
   }
 
 Reference*
@@ -139,11 +149,15 @@ do_on_scope_exit_slow(AIR_Status status)
     if(auto ptca = self.get_ptc_args_opt()) {
       // If a PTC wrapper was returned, prepend all deferred expressions
       // to it. These callbacks will be unpacked later, so we just return.
+      // Those of inner scopes are executed first, as they are executed
+      // backwards. `m_defer` must be left empty, as this context may be
+      // reused.
       auto& defer = ptca->defer();
       if(defer.empty())
         defer.swap(this->m_defer);
       else
-        defer.append(this->m_defer.move_begin(), this->m_defer.move_end());
+        defer.insert(0, this->m_defer.move_begin(), this->m_defer.move_end());
+      this->m_defer.clear();
     }
     else {
       // Execute all deferred expressions backwards.
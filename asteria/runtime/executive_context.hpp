@@ -21,6 +21,10 @@ class Executive_Context
     Reference_Stack* m_stack;
     Reference_Stack* m_alt_stack;  // for nested calls
 
+    // Local references are stored in frame slots, which have been assigned
+    // by analytic contexts at compile time.
+    cow_vector<Reference> m_slots;
+
     cow_bivector<Source_Location, AVMC_Queue> m_defer;
     refcnt_ptr<Variadic_Arguer> m_zvarg;
     cow_vector<Reference> m_lazy_args;
@@ -46,11 +50,22 @@ class Executive_Context
         m_global(&global), m_stack(&stack), m_alt_stack(&alt_stack),
         m_defer(::std::move(defer))  { }
 
-    // A function context has no parent.
+    // A capture context holds references that have been captured by a closure.
+    // It has no parent, and is the parent of the function context.
+    explicit
+    Executive_Context(M_capture, Global_Context& global, Reference_Stack& stack,
+                      Reference_Stack& alt_stack, const cow_vector<Reference>& captures)
+      : m_parent_opt(),
+        m_global(&global), m_stack(&stack), m_alt_stack(&alt_stack),
+        m_slots(captures)  { }
+
+    // A function context has no parent, unless it is a closure, whose parent
+    // is a capture context.
     // The caller shall define a global context and evaluation stack, both of which
     // shall outlast this context.
     explicit
-    Executive_Context(M_function, Global_Context& global, Reference_Stack& stack,
+    Executive_Context(M_function, Executive_Context* parent_opt,
+                      Global_Context& global, Reference_Stack& stack,
                       Reference_Stack& alt_stack, const refcnt_ptr<Variadic_Arguer>& zvarg,
                       const cow_vector<phsh_string>& params, Reference&& self);
 
@@ -97,6 +112,30 @@ class Executive_Context
     alt_stack() const noexcept
       { return *(this->m_alt_stack);  }
 
+    // These functions access local references by frame slot. A slot that
+    // has not been written yet contains an invalid reference.
+    const Reference*
+    get_local_slot_opt(uint32_t slot) const noexcept
+      { return this->m_slots.ptr(slot);  }
+
+    Reference&
+    mut_local_slot(uint32_t slot)
+      {
+        if(slot >= this->m_slots.size())
+          this->m_slots.append(slot + 1 - this->m_slots.size());
+        return this->m_slots.mut(slot);
+      }
+
+    // Clear all local references, so this context can be reused for the next
+    // iteration of a loop. `on_scope_exit()` must have been called.
+    void
+    reset() noexcept
+      {
+        ROCKET_ASSERT(this->m_defer.empty());
+        this->do_clear_named_references();
+        this->m_slots.clear();
+      }
+
     // Defer an expression which will be evaluated at scope exit.
     // The result of such expressions are discarded.
     void
@@ -5,9 +5,18 @@
 #include "garbage_collector.hpp"
 #include "variable.hpp"
 #include "../utils.hpp"
+#include <time.h>  // ::clock_gettime()
 namespace asteria {
 namespace {
 
+int64_t
+do_get_monotonic_ns() noexcept
+  {
+    ::timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+  }
+
 class Sentry
   {
   private:
@@ -46,127 +55,331 @@ Garbage_Collector::
   {
   }
 
-size_t
+void
 Garbage_Collector::
-do_collect_generation(size_t gen)
+do_abandon_cycle() noexcept
   {
-    // Ignore recursive requests.
-    const Sentry sentry(this->m_recur);
-    if(!sentry)
-      return 0;
+    // Return all variables to their generation.
+    auto& tracked = this->m_tracked.at(gMax - this->m_gen);
+    tracked.splice(this->m_young);
+    tracked.splice(this->m_unreach);
+    tracked.splice(this->m_pending);
+    tracked.splice(this->m_reach);
+
+    this->m_staged.clear();
+    this->m_temp.clear();
+    this->m_foreign.clear();
+    this->m_rescued.clear();
+
+    this->m_phase = phase_idle;
+    this->m_split = false;
+  }
 
+void
+Garbage_Collector::
+do_start_cycle(size_t gen)
+  {
+    this->do_abandon_cycle();
+
+    // Take all variables from this generation. Variables that are created
+    // later do not take part in this cycle.
+    this->m_gen = gen;
+    this->m_young.splice(this->m_tracked.at(gMax - gen));
+    this->m_cycle_size = this->m_young.size();
+    this->m_cycle_foreign = 0;
+    this->m_phase = phase_mark;
+  }
+
+void
+Garbage_Collector::
+do_record_pause(int64_t start_ns) noexcept
+  {
+    // Round the pause down to microseconds, and find its bucket, which is
+    // the number of significant bits.
+    uint64_t us = (uint64_t) (do_get_monotonic_ns() - start_ns) / 1000;
+    size_t k = (size_t) (64 - ROCKET_LZCNT64(us));
+    auto& pauses = this->m_stats.pauses;
+    pauses[::rocket::min(k, pauses.size() - 1)] ++;
+  }
+
+void
+Garbage_Collector::
+do_adapt_threshold() noexcept
+  {
+    // Estimate the efficiency of this cycle, which is the ratio of variables
+    // that have been collected to variables that have been visited. The
+    // former reflects the survival (or promotion) rate of this generation,
+    // and the latter reflects its cost, including foreign variables from
+    // other generations, which can be far more than its own ones.
+    size_t nsurv = this->m_reach.size();
+    size_t nfreed = this->m_cycle_size - nsurv;
+    size_t nwork = this->m_cycle_size + this->m_cycle_foreign;
+
+    // If few variables have been collected, this generation has been
+    // collected too often, so double its threshold. If most variables
+    // have been collected, it can be collected more often, so it doesn't
+    // grow too large, but make this gradual to avoid oscillation.
+    size_t& thres = this->m_thres[gMax - this->m_gen];
+    if(nfreed * 4 <= nwork)
+      thres = thres * 2;
+    else if(nfreed * 4 >= nwork * 3)
+      thres = thres - thres / 4;
+
+    thres = ::rocket::clamp(thres, this->m_thres_min[gMax - this->m_gen],
+                            this->m_thres_max[gMax - this->m_gen]);
+  }
+
+size_t
+Garbage_Collector::
+do_collect_slice(size_t budget)
+  {
     size_t nvars = 0;
+    bool reexamined = false;
+    size_t saved_budget = 0;
+    Variable* qvar;
     refcnt_ptr<Variable> var;
 
-    auto& tracked = this->m_tracked.at(gMax - gen);
-    const auto next_opt = (gen >= gMax) ? nullptr : &(this->m_tracked.at(gMax - gen - 1));
-    const auto count_opt = (gen >= gMax) ? nullptr : &(this->m_counts.at(gMax - gen - 1));
-
-    this->m_staged.clear();
-    this->m_temp_1.clear();
-    this->m_temp_2.clear();
-    this->m_unreach.clear();
-
-    // This algorithm is described at
-    //   https://pythoninternal.wordpress.com/2014/08/04/the-garbage-collector/
-    this->m_temp_1.merge(tracked);
-
-    while(do_pop_variable(var, this->m_temp_1)) {
-      // Each variable that is encountered here shall have a direct reference
-      // from either `tracked` or `m_staged`, so its `gc_ref` counter is
-      // initialized to one.
-      var->set_gc_ref(1);
-      ROCKET_ASSERT(var->get_gc_ref() <= var->use_count() - 1);
-      var->get_value().get_variables(this->m_staged, this->m_temp_1);
-    }
+    try {
+      // This algorithm is described at
+      //   https://pythoninternal.wordpress.com/2014/08/04/the-garbage-collector/
+      // Variables from this generation are moved between lists as they are
+      // examined. Each variable is tagged with the list that it belongs to,
+      // so membership tests don't require lookups. Foreign variables, which
+      // are reachable from this generation but do not belong to it, are kept
+      // in `m_foreign` instead.
+    r:
+      while(this->m_phase == phase_mark) {
+        if(budget == 0)
+          goto z;
+
+        qvar = this->m_young.front_opt();
+        if(qvar) {
+          // Enumerate all references from this variable.
+          budget --;
+          qvar->set_gc_ref(0);
+          qvar->get_value().get_variables(this->m_staged, this->m_temp);
+          this->m_unreach.transfer(this->m_young, qvar);
+          continue;
+        }
 
-    while(do_pop_variable(var, this->m_staged)) {
-      // Each key in `m_staged` denotes an internal reference, so its `gc_ref`
-      // counter shall be incremented.
-      var->set_gc_ref(var->get_gc_ref() + 1);
-      ROCKET_ASSERT(var->get_gc_ref() <= var->use_count() - 1);
-      this->m_temp_1.insert(var.get(), var);
-    }
+        if(do_pop_variable(var, this->m_temp)) {
+          // Enumerate all references from this variable, if it's foreign and
+          // hasn't been visited.
+          if(this->m_young.contains(var.get()) || this->m_unreach.contains(var.get()))
+            continue;
 
-    // Mark all variables that have been collected so far.
-    this->m_temp_1.merge(tracked);
+          if(!this->m_foreign.insert(var.get(), var))
+            continue;
 
-    if(next_opt)
-      next_opt->reserve_more(this->m_temp_1.size());
+          budget --;
+          this->m_cycle_foreign ++;
+          var->set_gc_ref(0);
+          var->get_value().get_variables(this->m_staged, this->m_temp);
+          continue;
+        }
 
-    while(do_pop_variable(var, this->m_temp_1)) {
-      // Each variable whose `gc_ref` counter equals its reference count is
-      // marked as possibly unreachable. Note `var` here owns a reference
-      // which must be excluded.
-      if(ROCKET_EXPECT(var->get_gc_ref() == var->use_count() - 1)) {
-        this->m_unreach.insert(var.get(), var);
-        continue;
+        var.reset();
+        this->m_phase = phase_count;
       }
 
-      // This variable is reachable.
-      this->m_temp_2.insert(var.get(), var);
+      while(this->m_phase == phase_count) {
+        if(budget == 0)
+          goto z;
 
-      while(do_pop_variable(var, this->m_temp_2)) {
-        // Mark this indirectly reachable variable, too.
-        var->set_gc_ref(0);
-        this->m_temp_1.erase(var.get());
-        this->m_unreach.erase(var.get());
+        if(do_pop_variable(var, this->m_staged)) {
+          // Each key in `m_staged` denotes an internal reference, so its `gc_ref`
+          // counter shall be incremented.
+          budget --;
+          if(this->m_unreach.contains(var.get()) || this->m_foreign.find_opt(var.get()))
+            var->set_gc_ref(var->get_gc_ref() + 1);
+          continue;
+        }
 
-        var->get_value().get_variables(this->m_staged, this->m_temp_2);
+        var.reset();
+        this->m_young.splice(this->m_unreach);
+        this->m_temp.swap(this->m_foreign);
+        this->m_phase = phase_scan;
+      }
 
-        if(!next_opt)
+      while(this->m_phase == phase_scan) {
+        if(budget == 0)
+          goto z;
+
+        qvar = this->m_young.front_opt();
+        if(qvar) {
+          // A variable whose reference count, excluding the one from its list,
+          // exceeds its `gc_ref` counter is referenced externally. Other ones
+          // are possibly unreachable.
+          budget --;
+          if(qvar->get_gc_ref() < qvar->use_count() - 1)
+            this->m_pending.transfer(this->m_young, qvar);
+          else
+            this->m_unreach.transfer(this->m_young, qvar);
           continue;
-
-        // Foreign variables must not be transferred.
-        if(!tracked.erase(var.get()))
+        }
+
+        if(do_pop_variable(var, this->m_temp)) {
+          // Do the same for foreign variables. Note `var` here owns a reference,
+          // and so does its list, if any.
+          budget --;
+          long nlist = var->get_gc_list() != 0;
+          if(var->get_gc_ref() < var->use_count() - 1 - nlist)
+            this->m_rescued.insert(var.get(), var);
+          else
+            this->m_foreign.insert(var.get(), var);
           continue;
+        }
+
+        var.reset();
+        this->m_phase = phase_trace;
+      }
 
-        // Transfer this variable to the next generation.
-        // Note that storage has been reserved so this shall not cause
-        // exceptions.
-        ROCKET_ASSERT(next_opt->size() < next_opt->capacity());
-        next_opt->insert(var.get(), var);
-        *count_opt += 1;
+      while(this->m_phase == phase_trace) {
+        if(budget == 0)
+          goto z;
+
+        qvar = this->m_pending.front_opt();
+        if(qvar) {
+          // Variables that are referenced by reachable ones are reachable, too.
+          budget --;
+          qvar->get_value().get_variables(this->m_staged, this->m_temp);
+          this->m_reach.transfer(this->m_pending, qvar);
+        }
+        else if(do_pop_variable(var, this->m_rescued)) {
+          // Do the same for foreign variables, which are not transferred.
+          budget --;
+          var->get_value().get_variables(this->m_staged, this->m_temp);
+        }
+        else {
+          var.reset();
+          this->m_staged.clear();
+          this->m_foreign.clear();
+          this->m_phase = phase_sweep;
+
+          // If the mutator has run during this cycle, reference counts that were
+          // calculated in previous slices are unreliable, so candidates have to
+          // be examined again. This is done in one go so the result is exact.
+          if(!this->m_split)
+            break;
+
+          this->m_split = false;
+          this->m_young.splice(this->m_unreach);
+          this->m_phase = phase_mark;
+          reexamined = true;
+          saved_budget = ::std::exchange(budget, SIZE_MAX);
+          goto r;
+        }
+
+        while(do_pop_variable(var, this->m_temp))
+          if(this->m_unreach.contains(var.get()))
+            this->m_pending.transfer(this->m_unreach, var.get());
+          else if(this->m_foreign.erase(var.get()))
+            this->m_rescued.insert(var.get(), var);
       }
     }
+    catch(...) {
+      // Abandon this cycle. Nothing has been collected so far.
+      this->do_abandon_cycle();
+      throw;
+    }
 
-    // Collect all variables from `m_unreach`.
-    while(do_pop_variable(var, this->m_unreach)) {
-      // Foreign variables must not be collected.
-      if(!tracked.erase(var.get()))
-        continue;
+    // Restore the budget if candidates have been examined again.
+    if(reexamined)
+      budget = saved_budget;
+
+    // Unreachable variables are not accessible by the mutator, so it is
+    // safe to collect them in multiple slices.
+    while(this->m_phase == phase_sweep) {
+      if(budget == 0)
+        goto z;
+
+      qvar = this->m_unreach.front_opt();
+      if(!qvar) {
+        if(this->m_adaptive)
+          this->do_adapt_threshold();
+
+        this->m_stats.cycles[this->m_gen] ++;
+        this->m_stats.scanned[this->m_gen] += this->m_cycle_size + this->m_cycle_foreign;
+
+        // Transfer reachable variables to the next generation.
+        size_t next = (this->m_gen >= gMax) ? this->m_gen : (this->m_gen + 1);
+        if(next != this->m_gen)
+          this->m_stats.promoted[this->m_gen] += this->m_reach.size();
+
+        this->m_counts[gMax - next] += this->m_reach.size();
+        this->m_tracked[gMax - next].splice(this->m_reach);
+
+        // Reset the GC counter to zero only if the operation completes
+        // normally i.e. don't reset it if an exception is thrown.
+        this->m_counts[gMax - this->m_gen] = 0;
+        this->m_phase = phase_idle;
+        break;
+      }
 
       // Cache the variable for later use.
-      // If an exception is thrown during uninitialization, the variable
-      // shall be collected immediately.
-      try {
-        ROCKET_ASSERT(var->get_gc_ref() != 0);
-        var->uninitialize();
-        nvars += 1;
-        this->m_pool.insert(var.get(), var);
-      }
-      catch(exception& stdex) {
-        ::fprintf(stderr,
-            "WARNING: An unusual exception that was thrown during garbage "
-            "collection has been caught and ignored. If this issue persists, "
-            "please file a bug report.\n"
-            "\n"
-            "  exception class: %s\n"
-            "  what(): %s\n",
-            typeid(stdex).name(), stdex.what());
+      budget --;
+      qvar->uninitialize();
+      nvars += 1;
+      this->m_stats.collected[this->m_gen] ++;
+      this->m_pool.transfer(this->m_unreach, qvar);
+    }
+
+    // Return the number of variables that have been collected.
+    return nvars;
+
+  z:
+    // The budget has been exhausted, so this cycle will be resumed later.
+    this->m_split = true;
+    return nvars;
+  }
+
+size_t
+Garbage_Collector::
+do_collect_step(size_t budget, bool force)
+  {
+    // Ignore recursive requests.
+    const Sentry sentry(this->m_recur);
+    if(!sentry)
+      return 0;
+
+    if(this->m_phase == phase_idle) {
+      // Start a new cycle on the newest generation that has exceeded its
+      // threshold.
+      size_t gen = 0;
+      while((gen <= gMax) && (this->m_counts[gMax-gen] < this->m_thres[gMax-gen]))
+        gen ++;
+
+      if(gen > gMax) {
+        if(!force)
+          return 0;
+
+        gen = 0;
       }
+
+      this->do_start_cycle(gen);
     }
 
-    this->m_staged.clear();
-    this->m_temp_1.clear();
-    this->m_temp_2.clear();
-    this->m_unreach.clear();
+    int64_t start_ns = do_get_monotonic_ns();
+    size_t nvars = this->do_collect_slice(budget);
+    this->do_record_pause(start_ns);
+    return nvars;
+  }
 
-    // Reset the GC counter to zero only if the operation completes
-    // normally i.e. don't reset it if an exception is thrown.
-    this->m_counts[gMax-gen] = 0;
+size_t
+Garbage_Collector::
+do_collect_generation(size_t gen)
+  {
+    // Ignore recursive requests.
+    const Sentry sentry(this->m_recur);
+    if(!sentry)
+      return 0;
 
-    // Return the number of variables that have been collected.
+    // Abandon the current cycle, if any, and collect this generation
+    // in full.
+    int64_t start_ns = do_get_monotonic_ns();
+    this->do_start_cycle(gen);
+    size_t nvars = this->do_collect_slice(SIZE_MAX);
+    this->do_record_pause(start_ns);
     return nvars;
   }
 
@@ -175,24 +388,51 @@ Garbage_Collector::
 create_variable(GC_Generation gen_hint)
   {
     // Perform automatic garbage collection.
-    for(size_t gen = 0;  gen <= gMax;  ++gen)
-      if(this->m_counts[gMax-gen] >= this->m_thres[gMax-gen])
-        this->do_collect_generation(gen);
+    if(this->m_step != 0)
+      this->do_collect_step(this->m_step, false);
+    else
+      for(size_t gen = 0;  gen <= gMax;  ++gen)
+        if(this->m_counts[gMax-gen] >= this->m_thres[gMax-gen])
+          this->do_collect_generation(gen);
 
     // Get a cached variable.
     // If the pool has been exhausted, allocate a new one.
-    refcnt_ptr<Variable> var;
-    this->m_pool.erase_random(nullptr, &var);
-    if(!var)
-      var = ::rocket::make_refcnt<Variable>();
+    auto var = this->m_pool.pop_front_opt();
+    if(var) {
+      this->m_stats.pool_hits ++;
+    }
+    else {
+      var.reset(new(this->m_slab) Variable());
+      this->m_stats.pool_misses ++;
+    }
 
     // Track it.
     size_t gen = gMax - gen_hint;
-    this->m_tracked.at(gen).insert(var.get(), var);
+    this->m_tracked.at(gen).push_back(var);
     this->m_counts[gen] += 1;
     return var;
   }
 
+refcnt_ptr<Variable>
+Garbage_Collector::
+create_untracked_variable()
+  {
+    // Get a cached variable.
+    // If the pool has been exhausted, allocate a new one.
+    auto var = this->m_pool.pop_front_opt();
+    if(var) {
+      this->m_stats.pool_hits ++;
+    }
+    else {
+      var.reset(new(this->m_slab) Variable());
+      this->m_stats.pool_misses ++;
+    }
+
+    // It is not tracked, so it will be freed when its last reference is
+    // released. It shall not be captured by any value.
+    return var;
+  }
+
 size_t
 Garbage_Collector::
 collect_variables(GC_Generation gen_limit)
@@ -208,6 +448,29 @@ collect_variables(GC_Generation gen_limit)
     return nvars;
   }
 
+size_t
+Garbage_Collector::
+collect_variables_step(size_t budget)
+  {
+    // Perform a slice of the current cycle. If no cycle is in progress,
+    // a new one is started.
+    return this->do_collect_step(::rocket::max(budget, (size_t) 1), true);
+  }
+
+size_t
+Garbage_Collector::
+count_tracked_variables(GC_Generation gen) const
+  {
+    size_t nvars = this->m_tracked.at(gMax-gen).size();
+
+    // Include variables from a cycle in progress.
+    if((this->m_phase != phase_idle) && (this->m_gen == gen))
+      nvars += this->m_young.size() + this->m_unreach.size()
+               + this->m_pending.size() + this->m_reach.size();
+
+    return nvars;
+  }
+
 size_t
 Garbage_Collector::
 finalize() noexcept
@@ -220,10 +483,7 @@ finalize() noexcept
     size_t nvars = 0;
     refcnt_ptr<Variable> var;
 
-    this->m_staged.clear();
-    this->m_temp_1.clear();
-    this->m_temp_2.clear();
-    this->m_unreach.clear();
+    this->do_abandon_cycle();
 
     // Wipe out all tracked variables. Indirect ones may be foreign so they
     // must not be wiped.
@@ -231,7 +491,7 @@ finalize() noexcept
       auto& tracked = this->m_tracked.at(gMax-gen);
       nvars += tracked.size();
 
-      while(tracked.erase_random(nullptr, &var))
+      while(!!(var = tracked.pop_front_opt()))
         var->uninitialize();
     }
 
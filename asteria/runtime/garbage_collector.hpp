@@ -6,24 +6,74 @@
 
 #include "../fwd.hpp"
 #include "../llds/variable_hashmap.hpp"
+#include "../llds/variable_list.hpp"
+#include "../llds/variable_slab.hpp"
 namespace asteria {
 
+// These are statistics of a garbage collector, which are accumulated since
+// its creation. Arrays of three elements are indexed by generation.
+struct GC_Statistics
+  {
+    ::std::array<uint64_t, 3> cycles = { };     // collections that have completed
+    ::std::array<uint64_t, 3> scanned = { };    // variables visited, including foreign ones
+    ::std::array<uint64_t, 3> collected = { };  // variables collected
+    ::std::array<uint64_t, 3> promoted = { };   // variables moved to the next generation
+    uint64_t pool_hits = 0;     // variables reused from the pool
+    uint64_t pool_misses = 0;   // variables allocated from the slab
+
+    // This is a histogram of pauses, which are either slices or full
+    // collections. The first element counts pauses shorter than one
+    // microsecond. Element `k` counts pauses in [2^(k-1), 2^k) us. The
+    // last element also counts all longer ones.
+    ::std::array<uint64_t, 20> pauses = { };
+  };
+
 class Garbage_Collector final
   : public rcfwd<Garbage_Collector>
   {
   private:
+    // These are states of an incremental collection cycle.
+    enum Phase : uint8_t
+      {
+        phase_idle   = 0,
+        phase_mark   = 1,  // enumerate references
+        phase_count  = 2,  // count internal references
+        phase_scan   = 3,  // find variables that are referenced externally
+        phase_trace  = 4,  // find variables that are referenced indirectly
+        phase_sweep  = 5,  // collect unreachable variables
+      };
+
     long m_recur = 0;
-    Variable_HashMap m_pool;  // key is a pointer to the `Variable` itself
+    Variable_Slab m_slab;  // storage of variables
 
     static constexpr size_t gMax = gc_generation_oldest;
     ::std::array<size_t, gMax+1> m_counts = { };
     ::std::array<size_t, gMax+1> m_thres = { 10, 70, 500 };
-    ::std::array<Variable_HashMap, gMax+1> m_tracked;
-
-    Variable_HashMap m_staged;  // key is address of the owner of a `Variable`
-    Variable_HashMap m_temp_1;  // key is address to a `Variable`
-    Variable_HashMap m_temp_2;
-    Variable_HashMap m_unreach;
+    ::std::array<size_t, gMax+1> m_thres_min = { 10, 10, 100 };
+    ::std::array<size_t, gMax+1> m_thres_max = { 100000, 100000, 100000 };
+    bool m_adaptive = false;
+    ::std::array<Variable_List, gMax+1> m_tracked = {{ Variable_List(1), Variable_List(2),
+                                                       Variable_List(3) }};
+    Variable_List m_pool = Variable_List(4);
+
+    // These lists hold variables from the generation being collected.
+    Variable_List m_young = Variable_List(5);    // not examined yet
+    Variable_List m_unreach = Variable_List(6);  // possibly unreachable
+    Variable_List m_pending = Variable_List(7);  // reachable but not traced
+    Variable_List m_reach = Variable_List(8);    // reachable
+
+    Variable_HashMap m_staged;   // key is address of the owner of a `Variable`
+    Variable_HashMap m_temp;     // key is address to a `Variable`
+    Variable_HashMap m_foreign;  // variables from other generations
+    Variable_HashMap m_rescued;  // foreign ones that are reachable
+
+    size_t m_step = 0;  // work budget of each slice; zero disables it
+    Phase m_phase = phase_idle;
+    bool m_split = false;  // has the mutator run since the cycle began?
+    size_t m_gen = 0;
+    size_t m_cycle_size = 0;     // number of variables from this generation
+    size_t m_cycle_foreign = 0;  // number of foreign variables visited
+    GC_Statistics m_stats;
 
   public:
     explicit
@@ -31,6 +81,29 @@ class Garbage_Collector final
       { }
 
   private:
+    inline
+    void
+    do_abandon_cycle() noexcept;
+
+    inline
+    void
+    do_start_cycle(size_t gen);
+
+    size_t
+    do_collect_slice(size_t budget);
+
+    inline
+    void
+    do_adapt_threshold() noexcept;
+
+    inline
+    void
+    do_record_pause(int64_t start_ns) noexcept;
+
+    inline
+    size_t
+    do_collect_step(size_t budget, bool force);
+
     inline
     size_t
     do_collect_generation(size_t gen);
@@ -47,9 +120,51 @@ class Garbage_Collector final
     set_threshold(GC_Generation gen, size_t thres)
       { this->m_thres.at(gMax-gen) = thres;  }
 
+    // If adaptive thresholds are enabled, the threshold of a generation is
+    // adjusted after each collection, according to the ratio of variables
+    // that have been collected to variables that have been visited. It is
+    // kept within the bounds below.
+    bool
+    get_adaptive_thresholds() const noexcept
+      { return this->m_adaptive;  }
+
+    void
+    set_adaptive_thresholds(bool adaptive) noexcept
+      { this->m_adaptive = adaptive;  }
+
+    size_t
+    get_min_threshold(GC_Generation gen) const
+      { return this->m_thres_min.at(gMax-gen);  }
+
+    size_t
+    get_max_threshold(GC_Generation gen) const
+      { return this->m_thres_max.at(gMax-gen);  }
+
+    void
+    set_threshold_bounds(GC_Generation gen, size_t min, size_t max)
+      {
+        this->m_thres_min.at(gMax-gen) = min;
+        this->m_thres_max.at(gMax-gen) = ::rocket::max(min, max);
+      }
+
+    // The step budget is the maximum number of variables that may be
+    // visited by a single slice of an incremental collection cycle. If
+    // it is zero, a generation is collected in full whenever its
+    // threshold is exceeded.
+    size_t
+    get_step_budget() const noexcept
+      { return this->m_step;  }
+
+    void
+    set_step_budget(size_t budget) noexcept
+      { this->m_step = budget;  }
+
+    bool
+    is_collecting() const noexcept
+      { return this->m_phase != phase_idle;  }
+
     size_t
-    count_tracked_variables(GC_Generation gen) const
-      { return this->m_tracked.at(gMax-gen).size();  }
+    count_tracked_variables(GC_Generation gen) const;
 
     size_t
     count_pooled_variables() const noexcept
@@ -59,13 +174,34 @@ class Garbage_Collector final
     clear_pooled_variables() noexcept
       { this->m_pool.clear();  }
 
+    size_t
+    count_slab_chunks() const noexcept
+      { return this->m_slab.count_chunks();  }
+
+    const GC_Statistics&
+    get_statistics() const noexcept
+      { return this->m_stats;  }
+
+    void
+    clear_statistics() noexcept
+      { this->m_stats = { };  }
+
     // Allocation and collection
     refcnt_ptr<Variable>
     create_variable(GC_Generation gen_hint = gc_generation_newest);
 
+    // Creates a variable that is not tracked. This is only safe if no
+    // reference to it may be captured, such as a local variable that does
+    // not escape its function.
+    refcnt_ptr<Variable>
+    create_untracked_variable();
+
     size_t
     collect_variables(GC_Generation gen_limit = gc_generation_oldest);
 
+    size_t
+    collect_variables_step(size_t budget);
+
     size_t
     finalize() noexcept;
   };
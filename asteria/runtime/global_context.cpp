@@ -6,6 +6,7 @@
 #include "garbage_collector.hpp"
 #include "random_engine.hpp"
 #include "module_loader.hpp"
+#include "call_pool.hpp"
 #include "variable.hpp"
 #include "abstract_hooks.hpp"
 #include "../library/version.hpp"
@@ -77,7 +78,8 @@ Global_Context::
 Global_Context(API_Version version)
   : m_gcoll(::rocket::make_refcnt<Garbage_Collector>()),
     m_prng(::rocket::make_refcnt<Random_Engine>()),
-    m_ldrlk(::rocket::make_refcnt<Module_Loader>())
+    m_ldrlk(::rocket::make_refcnt<Module_Loader>()),
+    m_calls(::rocket::make_refcnt<Call_Pool>())
   {
     // Get the range of modules to initialize.
     // This also determines the maximum version number of the library, which
@@ -19,6 +19,7 @@ class Global_Context
     rcfwd_ptr<Garbage_Collector> m_gcoll;
     rcfwd_ptr<Random_Engine> m_prng;
     rcfwd_ptr<Module_Loader> m_ldrlk;
+    rcfwd_ptr<Call_Pool> m_calls;
     rcfwd_ptr<Variable> m_vstd;
 
   public:
@@ -90,6 +91,13 @@ class Global_Context
     module_loader() const noexcept
       { return unerase_pointer_cast<Module_Loader>(this->m_ldrlk);  }
 
+    // The call pool is used by every function call, so it is returned by
+    // reference without touching its reference count.
+    ASTERIA_INCOMPLET(Call_Pool)
+    Call_Pool&
+    call_pool() const noexcept
+      { return *(unerase_cast<Call_Pool*>(this->m_calls));  }
+
     ASTERIA_INCOMPLET(Variable)
     refcnt_ptr<Variable>
     std_variable() const noexcept
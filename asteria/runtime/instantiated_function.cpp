@@ -8,6 +8,7 @@
 #include "global_context.hpp"
 #include "runtime_error.hpp"
 #include "ptc_arguments.hpp"
+#include "call_pool.hpp"
 #include "enums.hpp"
 #include "../llds/reference_stack.hpp"
 #include "../utils.hpp"
@@ -20,11 +21,14 @@ Instantiated_Function::
 
 void
 Instantiated_Function::
-do_solidify(const cow_vector<AIR_Node>& code)
+do_solidify(const Compiler_Options& opts, const cow_vector<AIR_Node>& code)
   {
     this->m_queue.clear();
-    ::rocket::all_of(code, [&](const AIR_Node& node) { return node.solidify(this->m_queue);  });
+    AIR_Node::solidify_all(this->m_queue, code);
     this->m_queue.finalize();
+
+    if(opts.jit_compilation)
+      this->m_queue.jit_compile();
   }
 
 tinyfmt&
@@ -39,21 +43,33 @@ Instantiated_Function::
 get_variables(Variable_HashMap& staged, Variable_HashMap& temp) const
   {
     this->m_queue.get_variables(staged, temp);
+
+    if(this->m_proto_opt)
+      this->m_proto_opt->get_variables(staged, temp);
+
+    for(const auto& ref : this->m_captures)
+      ref.get_variables(staged, temp);
   }
 
 Reference&
 Instantiated_Function::
 invoke_ptc_aware(Reference& self, Global_Context& global, Reference_Stack&& stack) const
   {
-    // Create the stack and context for this function.
+    // Create the stack and context for this function. Captured references
+    // are stored in the parent context. The stack for nested calls is taken
+    // from the pool, as most functions make calls.
     AIR_Status status;
-    Reference_Stack alt_stack;
-    Executive_Context ctx_func(Executive_Context::M_function(), global,
-          stack, alt_stack, this->m_zvarg, this->m_params, ::std::move(self));
+    Call_Pool::Unique_Stack alt_stack(global.call_pool());
+    Executive_Context ctx_capt(Executive_Context::M_capture(), global,
+          stack, alt_stack.get(), this->m_captures);
+    Executive_Context ctx_func(Executive_Context::M_function(), &ctx_capt, global,
+          stack, alt_stack.get(), this->m_zvarg, this->m_params, ::std::move(self));
 
-    // Execute the function body.
+    // Execute the function body. If this is a closure, its code is in the
+    // prototype.
+    const auto& queue = this->m_proto_opt ? this->m_proto_opt->m_queue : this->m_queue;
     try {
-      status = this->m_queue.execute(ctx_func);
+      status = queue.execute(ctx_func);
     }
     catch(Runtime_Error& except) {
       ctx_func.on_scope_exit(except);
@@ -17,16 +17,28 @@ class Instantiated_Function final
     refcnt_ptr<Variadic_Arguer> m_zvarg;
     AVMC_Queue m_queue;
 
+    // Closures that are created from the same definition share the code of
+    // a prototype, and only store references that they have captured.
+    refcnt_ptr<const Instantiated_Function> m_proto_opt;
+    cow_vector<Reference> m_captures;
+
   public:
     explicit
-    Instantiated_Function(const cow_vector<phsh_string>& params, refcnt_ptr<Variadic_Arguer>&& zvarg,
-                          const cow_vector<AIR_Node>& code)
+    Instantiated_Function(const Compiler_Options& opts, const cow_vector<phsh_string>& params,
+                          refcnt_ptr<Variadic_Arguer>&& zvarg, const cow_vector<AIR_Node>& code)
       : m_params(params), m_zvarg(::std::move(zvarg))
-      { this->do_solidify(code);  }
+      { this->do_solidify(opts, code);  }
+
+    explicit
+    Instantiated_Function(const refcnt_ptr<const Instantiated_Function>& proto,
+                          cow_vector<Reference>&& captures)
+      : m_params(proto->m_params), m_zvarg(proto->m_zvarg),
+        m_proto_opt(proto), m_captures(::std::move(captures))
+      { }
 
   private:
     void
-    do_solidify(const cow_vector<AIR_Node>& code);
+    do_solidify(const Compiler_Options& opts, const cow_vector<AIR_Node>& code);
 
   public:
     ASTERIA_NONCOPYABLE_DESTRUCTOR(Instantiated_Function);
@@ -3,6 +3,7 @@
 
 #include "../precompiled.ipp"
 #include "ptc_arguments.hpp"
+#include "../llds/avmc_queue.hpp"
 #include "../utils.hpp"
 namespace asteria {
 
@@ -11,4 +12,15 @@ PTC_Arguments::
   {
   }
 
+void
+PTC_Arguments::
+clear() noexcept
+  {
+    this->m_target = nullptr;
+    this->m_stack.clear();
+    this->m_stack.clear_cache();
+    this->m_caller_opt = nullptr;
+    this->m_defer.clear();
+  }
+
 }  // namespace asteria
@@ -35,6 +35,21 @@ class PTC_Arguments final
   public:
     ASTERIA_COPYABLE_DESTRUCTOR(PTC_Arguments);
 
+    // These are used by `Call_Pool` to recycle objects. Arguments are
+    // swapped with `stack`, which receives the storage of the old stack.
+    void
+    reset(const Source_Location& sloc, PTC_Aware ptc, const cow_function& target,
+          Reference_Stack& stack) noexcept
+      {
+        this->m_sloc = sloc;
+        this->m_ptc = ptc;
+        this->m_target = target;
+        this->m_stack.swap(stack);
+      }
+
+    void
+    clear() noexcept;
+
     const Source_Location&
     sloc() const noexcept
       { return this->m_sloc;  }
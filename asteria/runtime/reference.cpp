@@ -9,12 +9,24 @@
 #include "runtime_error.hpp"
 #include "variable.hpp"
 #include "ptc_arguments.hpp"
+#include "call_pool.hpp"
 #include "enums.hpp"
 #include "../llds/avmc_queue.hpp"
 #include "../llds/reference_stack.hpp"
 #include "../llds/variable_hashmap.hpp"
 #include "../utils.hpp"
 namespace asteria {
+namespace {
+
+struct PTC_Frame
+  {
+    Source_Location sloc;
+    cow_function target;
+    refcnt_ptr<const Variadic_Arguer> caller_opt;
+    refcnt_ptr<PTC_Arguments> defer_opt;  // set if there are deferred expressions
+  };
+
+}  // namespace
 
 const Value&
 Reference::
@@ -61,6 +73,12 @@ do_dereference_readonly_slow() const
     }
 
     // Apply modifiers.
+    if(this->m_mod0 != 0) {
+      qval = Reference_Modifier::apply_read_opt(*qval, this->do_mod0_index(),
+                                      this->do_mod0_ival(), this->do_mod0_key_opt());
+      return qval ? *qval : null_value;
+    }
+
     auto bpos = this->m_mods.begin();
     auto epos = this->m_mods.end();
 
@@ -86,10 +104,14 @@ Reference::
 do_finish_call_slow(Global_Context& global)
   {
     // We must rebuild the backtrace using this queue if an exception is thrown.
-    cow_vector<refcnt_ptr<PTC_Arguments>> frames;
+    // Arguments are kept only if there are deferred expressions, which must be
+    // evaluated after all calls return. Others are recycled when their calls
+    // return, so a chain of proper tail calls does not allocate new ones.
+    cow_vector<PTC_Frame> frames;
     refcnt_ptr<PTC_Arguments> ptca;
     int ptc_conj = ptc_aware_by_ref;
     Reference_Stack alt_stack;
+    auto& pool = global.call_pool();
 
     try {
       // Unpack all frames recursively.
@@ -97,7 +119,7 @@ do_finish_call_slow(Global_Context& global)
       while(this->m_index == index_ptc_args) {
         ROCKET_ASSERT(this->m_ptca.use_count() == 1);
         ptca.reset(static_cast<PTC_Arguments*>(this->m_ptca.release()));
-        this->m_index = index_invalid;
+        this->set_invalid();
 
         // Generate a single-step trap before unpacking arguments.
         if(auto qhooks = global.get_hooks_opt())
@@ -113,56 +135,61 @@ do_finish_call_slow(Global_Context& global)
           qhooks->on_function_call(ptca->sloc(), ptca->target());
 
         // Record this frame.
-        frames.emplace_back(ptca);
+        PTC_Frame frame = { ptca->sloc(), ptca->target(), ptca->caller_opt(), nullptr };
+        if(ptca->defer().size())
+          frame.defer_opt = ptca;
+
+        frames.emplace_back(::std::move(frame));
         ptc_conj |= ptca->ptc_aware();
 
         // Perform a non-tail call.
         ptca->target().invoke_ptc_aware(*this, global, ::std::move(stack));
+        pool.recycle_ptc_arguments(::std::move(ptca));
       }
 
       // Check for deferred expressions.
       while(frames.size()) {
         // Pop frames in reverse order.
-        ptca = ::std::move(frames.mut_back());
+        auto frame = ::std::move(frames.mut_back());
         frames.pop_back();
 
         // Evaluate deferred expressions if any.
-        if(ptca->defer().size())
-          Executive_Context(Executive_Context::M_defer(), global, ptca->stack(),
-                            alt_stack, ::std::move(ptca->defer()))
+        if(frame.defer_opt)
+          Executive_Context(Executive_Context::M_defer(), global, frame.defer_opt->stack(),
+                            alt_stack, ::std::move(frame.defer_opt->defer()))
             .on_scope_exit(air_status_next);
 
         // Call the hook function if any.
         if(auto qhooks = global.get_hooks_opt())
-          qhooks->on_function_return(ptca->sloc(), ptca->target(), *this);
+          qhooks->on_function_return(frame.sloc, frame.target, *this);
       }
     }
     catch(Runtime_Error& except) {
       // Check for deferred expressions.
       while(frames.size()) {
         // Pop frames in reverse order.
-        ptca = ::std::move(frames.mut_back());
+        auto frame = ::std::move(frames.mut_back());
         frames.pop_back();
 
         // Push the function call.
-        except.push_frame_plain(ptca->sloc(), sref("[proper tail call]"));
+        except.push_frame_plain(frame.sloc, sref("[proper tail call]"));
 
         // Call the hook function if any.
         if(auto qhooks = global.get_hooks_opt())
-          qhooks->on_function_except(ptca->sloc(), ptca->target(), except);
+          qhooks->on_function_except(frame.sloc, frame.target, except);
 
         // Evaluate deferred expressions if any.
-        if(ptca->defer().size())
-          Executive_Context(Executive_Context::M_defer(), global, ptca->stack(),
-                            alt_stack, ::std::move(ptca->defer()))
+        if(frame.defer_opt)
+          Executive_Context(Executive_Context::M_defer(), global, frame.defer_opt->stack(),
+                            alt_stack, ::std::move(frame.defer_opt->defer()))
             .on_scope_exit(except);
 
         // Push the caller.
         // Note that if we arrive here, there must have been an exception thrown when
         // unpacking the last frame (i.e. the last call did not return), so the last
         // frame does not have its enclosing function set.
-        if(auto qcall = ptca->caller_opt())
-          except.push_frame_func(qcall->sloc(), qcall->func());
+        if(frame.caller_opt)
+          except.push_frame_func(frame.caller_opt->sloc(), frame.caller_opt->func());
       }
       throw;
     }
@@ -179,15 +206,73 @@ do_finish_call_slow(Global_Context& global)
     return *this;
   }
 
+Reference&
+Reference::
+do_push_modifier_slow(Reference_Modifier&& xmod)
+  {
+    if(this->m_mod0 == 0) {
+      this->m_mods.emplace_back(::std::move(xmod));
+      return *this;
+    }
+
+    // Copy the modifier in place into a new vector, followed by the new one,
+    // so `*this` is left intact if an exception is thrown.
+    cow_vector<Reference_Modifier> mods;
+    mods.reserve(2);
+    mods.emplace_back(this->modifier(0));
+    mods.emplace_back(::std::move(xmod));
+
+    this->clear_modifiers();
+    this->m_mods.swap(mods);
+    return *this;
+  }
+
+Reference_Modifier
+Reference::
+modifier(size_t index) const
+  {
+    if(this->m_mod0 == 0)
+      return this->m_mods.at(index);
+
+    if(index != 0)
+      ::rocket::sprintf_and_throw<::std::out_of_range>(
+          "Reference: modifier index out of range (`%zu` >= `1`)",
+          index);
+
+    switch(this->do_mod0_index()) {
+      case Reference_Modifier::index_array_index:
+        return Reference_Modifier::S_array_index{ this->m_mod0_ival };
+
+      case Reference_Modifier::index_object_key:
+        return Reference_Modifier::S_object_key{ *(this->do_mod0_key()) };
+
+      case Reference_Modifier::index_array_head:
+        return Reference_Modifier::S_array_head{ };
+
+      case Reference_Modifier::index_array_tail:
+        return Reference_Modifier::S_array_tail{ };
+
+      case Reference_Modifier::index_array_random:
+        return Reference_Modifier::S_array_random{ static_cast<uint32_t>(this->m_mod0_ival) };
+
+      default:
+        ASTERIA_TERMINATE((
+            "Invalid reference modifier type (index `$1`)"),
+            this->do_mod0_index());
+    }
+  }
+
 void
 Reference::
 get_variables(Variable_HashMap& staged, Variable_HashMap& temp) const
   {
-    this->m_value.get_variables(staged, temp);
+    if(do_holds_value(this->m_index))
+      this->m_value.get_variables(staged, temp);
 
-    if(auto var = unerase_pointer_cast<Variable>(this->m_var))
-      if(staged.insert(&(this->m_var), var))
-        temp.insert(var.get(), var);
+    if(this->m_index == index_variable)
+      if(auto var = unerase_pointer_cast<Variable>(this->m_var))
+        if(staged.insert(&(this->m_var), var))
+          temp.insert(var.get(), var);
   }
 
 Value&
@@ -240,6 +325,10 @@ dereference_mutable() const
     }
 
     // Apply modifiers.
+    if(this->m_mod0 != 0)
+      return Reference_Modifier::apply_open(*qval, this->do_mod0_index(),
+                                      this->do_mod0_ival(), this->do_mod0_key_opt());
+
     auto bpos = this->m_mods.begin();
     auto epos = this->m_mods.end();
 
@@ -295,6 +384,10 @@ dereference_unset() const
     }
 
     // Apply modifiers except the last one.
+    if(this->m_mod0 != 0)
+      return Reference_Modifier::apply_unset(*qval, this->do_mod0_index(),
+                                      this->do_mod0_ival(), this->do_mod0_key_opt());
+
     auto bpos = this->m_mods.begin();
     auto epos = this->m_mods.end();
 
@@ -22,90 +22,218 @@ class Reference
       };
 
   private:
-    Value m_value;
-    rcfwd_ptr<Variable> m_var;
-    rcfwd_ptr<PTC_Arguments> m_ptca;
-    cow_vector<Reference_Modifier> m_mods;
+    // These fields are mutually exclusive. `m_value` is active for invalid,
+    // void and temporary references, `m_var` is active for variables, and
+    // `m_ptca` is active for proper tail calls. All of them may be relocated
+    // bitwise and are all-zero bits when null, like `Value`.
+    union {
+      char m_bytes[sizeof(Value)];
+      Value m_value;
+      rcfwd_ptr<Variable> m_var;
+      rcfwd_ptr<PTC_Arguments> m_ptca;
+    };
+
+    // A single modifier is stored in place, so `a[i]` and `obj.key` do not
+    // allocate memory. Its type is `m_mod0` minus one. An index or a seed is
+    // stored in `m_mod0_ival`. A key is stored right after `m_var`, spanning
+    // `m_mod0_ival`, so it is stored in place only for variables. If `m_mod0`
+    // is zero, `m_mods` is active and contains all modifiers.
+    union {
+      char m_mods_bytes[sizeof(cow_vector<Reference_Modifier>)];
+      cow_vector<Reference_Modifier> m_mods;
+      int64_t m_mod0_ival;
+    };
 
     union {
-      Index m_index;
+      struct {
+        Index m_index;
+        uint8_t m_mod0;
+      };
       void* m_init_index;  // force initialization of padding bits
     };
 
+    static constexpr uint8_t mod0_key = Reference_Modifier::index_object_key + 1;
+
   public:
     // Constructors and assignment operators
     constexpr
     Reference() noexcept
-      : m_init_index()  { }
+      : m_bytes(), m_mods(), m_init_index()  { }
 
     Reference(const Reference& other) noexcept
-      : m_mods(other.m_mods),
-        m_index(other.m_index)
+      : m_bytes(), m_mods_bytes(), m_init_index()
       {
         this->do_copy_partial(other);
+        this->m_index = other.m_index;
+
+        if(other.m_mod0 == 0)
+          ::rocket::construct(&(this->m_mods), other.m_mods);
+        else if(other.m_mod0 == mod0_key)
+          ::rocket::construct(this->do_mut_mod0_key(), *(other.do_mod0_key()));
+        else
+          this->m_mod0_ival = other.m_mod0_ival;
+        this->m_mod0 = other.m_mod0;
       }
 
     Reference(Reference&& other) noexcept
-      : m_mods(::std::move(other.m_mods)),
-        m_index(other.m_index)
+      : m_init_index()
       {
-        this->do_swap_partial(other);
+        // Don't play with this at home!
+        ::std::memcpy(this->m_bytes, other.m_bytes, sizeof(Value));
+        ::std::memset(other.m_bytes, 0, sizeof(Value));
+        this->m_index = other.m_index;
+
+        ::std::memcpy(this->m_mods_bytes, other.m_mods_bytes, sizeof(m_mods));
+        ::std::memset(other.m_mods_bytes, 0, sizeof(m_mods));
+        this->m_mod0 = ::std::exchange(other.m_mod0, uint8_t());
       }
 
     Reference&
     operator=(const Reference& other) & noexcept
       {
-        this->do_copy_partial(other);
-        this->m_mods = other.m_mods;
-        this->m_index = other.m_index;
+        Reference(other).swap(*this);
         return *this;
       }
 
     Reference&
     operator=(Reference&& other) & noexcept
       {
-        this->do_swap_partial(other);
-        this->m_mods = ::std::move(other.m_mods);
-        this->m_index = other.m_index;
+        this->swap(other);
         return *this;
       }
 
     Reference&
     swap(Reference& other) noexcept
       {
-        this->do_swap_partial(other);
-        this->m_mods.swap(other.m_mods);
+        // Don't play with this at home!
+        char temp[sizeof(Value)];
+        ::std::memcpy(temp, this->m_bytes, sizeof(Value));
+        ::std::memcpy(this->m_bytes, other.m_bytes, sizeof(Value));
+        ::std::memcpy(other.m_bytes, temp, sizeof(Value));
         ::std::swap(this->m_index, other.m_index);
+
+        char mtemp[sizeof(m_mods)];
+        ::std::memcpy(mtemp, this->m_mods_bytes, sizeof(m_mods));
+        ::std::memcpy(this->m_mods_bytes, other.m_mods_bytes, sizeof(m_mods));
+        ::std::memcpy(other.m_mods_bytes, mtemp, sizeof(m_mods));
+        ::std::swap(this->m_mod0, other.m_mod0);
         return *this;
       }
 
+    ~Reference()
+      {
+        if(this->m_mod0 == 0)
+          ::rocket::destroy(&(this->m_mods));
+        else if(this->m_mod0 == mod0_key)
+          ::rocket::destroy(this->do_mut_mod0_key());
+
+        this->do_destroy_partial();
+      }
+
   private:
+    static constexpr
+    bool
+    do_holds_value(Index index) noexcept
+      { return index < index_variable;  }
+
     ROCKET_ALWAYS_INLINE
     void
     do_copy_partial(const Reference& other)
       {
+        // `*this` shall have been zero-initialized.
         const uint32_t index = other.m_index;
         if(index == index_temporary)
-          this->m_value = other.m_value;
+          ::rocket::construct(&(this->m_value), other.m_value);
+        if(index == index_variable)
+          ::rocket::construct(&(this->m_var), other.m_var);
+        if(index == index_ptc_args)
+          ::rocket::construct(&(this->m_ptca), other.m_ptca);
+      }
+
+    ROCKET_ALWAYS_INLINE
+    void
+    do_destroy_partial() noexcept
+      {
+        const uint32_t index = this->m_index;
+        if(do_holds_value(static_cast<Index>(index)))
+          ::rocket::destroy(&(this->m_value));
         if(index == index_variable)
-          this->m_var = other.m_var;
+          ::rocket::destroy(&(this->m_var));
         if(index == index_ptc_args)
-          this->m_ptca = other.m_ptca;
+          ::rocket::destroy(&(this->m_ptca));
+      }
+
+    ROCKET_ALWAYS_INLINE
+    void
+    do_clear_partial() noexcept
+      {
+        // Destroy the active field and leave null bits behind, which are
+        // valid for all fields. There shall be no key in place.
+        ROCKET_ASSERT(this->m_mod0 != mod0_key);
+        this->do_destroy_partial();
+        ::std::memset(this->m_bytes, 0, sizeof(Value));
+      }
+
+    template<typename ObjT>
+    ROCKET_ALWAYS_INLINE
+    void
+    do_replace_partial(ObjT* qobj, ObjT& obj) noexcept
+      {
+        // Relocate `obj` into `*qobj`, which overlaps the active field. This
+        // shall be used when the active field changes. `obj` is left null.
+        ROCKET_ASSERT((void*) qobj == (void*) this->m_bytes);
+        this->do_clear_partial();
+        ::std::memcpy((void*) qobj, (const void*) &obj, sizeof(ObjT));
+        ::std::memset((void*) &obj, 0, sizeof(ObjT));
       }
 
+    const phsh_string*
+    do_mod0_key() const noexcept
+      {
+        // Don't play with this at home!
+        static_assert(sizeof(void*) + sizeof(phsh_string) == sizeof(Value) + sizeof(m_mods), "");
+        return (const phsh_string*) ((const char*) this + sizeof(void*));
+      }
+
+    phsh_string*
+    do_mut_mod0_key() noexcept
+      { return (phsh_string*) ((char*) this + sizeof(void*));  }
+
+    Reference_Modifier::Index
+    do_mod0_index() const noexcept
+      { return static_cast<Reference_Modifier::Index>(this->m_mod0 - 1);  }
+
+    int64_t
+    do_mod0_ival() const noexcept
+      { return (this->m_mod0 == mod0_key) ? 0 : this->m_mod0_ival;  }
+
+    const phsh_string*
+    do_mod0_key_opt() const noexcept
+      { return (this->m_mod0 == mod0_key) ? this->do_mod0_key() : nullptr;  }
+
+    ROCKET_ALWAYS_INLINE
+    bool
+    do_can_push_mod0() const noexcept
+      {
+        // Don't store the modifier in place if it would free the storage of
+        // `m_mods`, which may be reused.
+        return (this->m_mod0 == 0) && (this->m_mods.capacity() == 0);
+      }
+
+    template<Reference_Modifier::Index indexT>
     ROCKET_ALWAYS_INLINE
     void
-    do_swap_partial(Reference& other)
+    do_set_mod0(int64_t ival) noexcept
       {
-        const bmask32 mask = { this->m_index, other.m_index };
-        if(mask.test(index_temporary))
-          this->m_value.swap(other.m_value);
-        if(mask.test(index_variable))
-          this->m_var.swap(other.m_var);
-        if(mask.test(index_ptc_args))
-          this->m_ptca.swap(other.m_ptca);
+        ROCKET_ASSERT(this->m_mods.empty());
+        ::rocket::destroy(&(this->m_mods));
+        this->m_mod0_ival = ival;
+        this->m_mod0 = indexT + 1;
       }
 
+    Reference&
+    do_push_modifier_slow(Reference_Modifier&& xmod);
+
     const Value&
     do_dereference_readonly_slow() const;
 
@@ -132,6 +260,10 @@ class Reference
     Reference&
     set_invalid() noexcept
       {
+        this->clear_modifiers();
+        if(!do_holds_value(this->m_index))
+          this->do_clear_partial();
+
         this->m_index = index_invalid;
         return *this;
       }
@@ -143,6 +275,10 @@ class Reference
     Reference&
     set_void() noexcept
       {
+        this->clear_modifiers();
+        if(!do_holds_value(this->m_index))
+          this->do_clear_partial();
+
         this->m_index = index_void;
         return *this;
       }
@@ -155,8 +291,15 @@ class Reference
     Reference&
     set_temporary(XValT&& xval) noexcept
       {
-        this->m_value = ::std::forward<XValT>(xval);
-        this->m_mods.clear();
+        this->clear_modifiers();
+        if(ROCKET_EXPECT(do_holds_value(this->m_index)))
+          this->m_value = ::std::forward<XValT>(xval);
+        else {
+          // Note `xval` may be owned by the variable.
+          Value val(::std::forward<XValT>(xval));
+          this->do_replace_partial(&(this->m_value), val);
+        }
+
         this->m_index = index_temporary;
         return *this;
       }
@@ -178,8 +321,14 @@ class Reference
     Reference&
     set_variable(const refcnt_ptr<Variable>& var) noexcept
       {
-        this->m_var = var;
-        this->m_mods.clear();
+        this->clear_modifiers();
+        if(ROCKET_EXPECT(this->m_index == index_variable))
+          this->m_var = var;
+        else {
+          rcfwd_ptr<Variable> ptr(var);
+          this->do_replace_partial(&(this->m_var), ptr);
+        }
+
         this->m_index = index_variable;
         return *this;
       }
@@ -201,7 +350,14 @@ class Reference
     Reference&
     set_ptc_args(const refcnt_ptr<PTC_Arguments>& ptca) noexcept
       {
-        this->m_ptca = ptca;
+        this->clear_modifiers();
+        if(this->m_index == index_ptc_args)
+          this->m_ptca = ptca;
+        else {
+          rcfwd_ptr<PTC_Arguments> ptr(ptca);
+          this->do_replace_partial(&(this->m_ptca), ptr);
+        }
+
         this->m_index = index_ptc_args;
         return *this;
       }
@@ -214,61 +370,81 @@ class Reference
     // For instance, the expression `obj.x[42]` results in a reference having two
     // modifiers. Modifiers can be removed to yield references to ancestor objects.
     // Removing the last modifier shall yield the constant `null`.
-    const cow_vector<Reference_Modifier>&
-    get_modifiers() const noexcept
-      { return this->m_mods;  }
+    size_t
+    count_modifiers() const noexcept
+      { return (this->m_mod0 != 0) ? 1 : this->m_mods.size();  }
 
-    Reference&
-    set_modifiers(const cow_vector<Reference_Modifier>& mods) noexcept
-      {
-        this->m_mods = mods;
-        return *this;
-      }
+    // A modifier that is stored in place has to be reconstructed, so this
+    // function returns a copy.
+    Reference_Modifier
+    modifier(size_t index) const;
 
     Reference&
     clear_modifiers() noexcept
       {
-        this->m_mods.clear();
+        if(ROCKET_EXPECT(this->m_mod0 == 0)) {
+          this->m_mods.clear();
+          return *this;
+        }
+
+        if(this->m_mod0 == mod0_key)
+          ::rocket::destroy(this->do_mut_mod0_key());
+
+        ::rocket::construct(&(this->m_mods));
+        this->m_mod0 = 0;
         return *this;
       }
 
     Reference&
     push_modifier_array_index(int64_t index)
       {
-        Reference_Modifier::S_array_index xmod = { index };
-        this->m_mods.emplace_back(::std::move(xmod));
+        if(ROCKET_UNEXPECT(!this->do_can_push_mod0()))
+          return this->do_push_modifier_slow(Reference_Modifier::S_array_index{ index });
+
+        this->do_set_mod0<Reference_Modifier::index_array_index>(index);
         return *this;
       }
 
     Reference&
     push_modifier_object_key(phsh_stringR key)
       {
-        Reference_Modifier::S_object_key xmod = { key };
-        this->m_mods.emplace_back(::std::move(xmod));
+        if(ROCKET_UNEXPECT(!this->do_can_push_mod0() || (this->m_index != index_variable)))
+          return this->do_push_modifier_slow(Reference_Modifier::S_object_key{ key });
+
+        ROCKET_ASSERT(this->m_mods.empty());
+        ::rocket::destroy(&(this->m_mods));
+        ::rocket::construct(this->do_mut_mod0_key(), key);
+        this->m_mod0 = mod0_key;
         return *this;
       }
 
     Reference&
     push_modifier_array_head()
       {
-        Reference_Modifier::S_array_head xmod = { };
-        this->m_mods.emplace_back(::std::move(xmod));
+        if(ROCKET_UNEXPECT(!this->do_can_push_mod0()))
+          return this->do_push_modifier_slow(Reference_Modifier::S_array_head{ });
+
+        this->do_set_mod0<Reference_Modifier::index_array_head>(0);
         return *this;
       }
 
     Reference&
     push_modifier_array_tail()
       {
-        Reference_Modifier::S_array_tail xmod = { };
-        this->m_mods.emplace_back(::std::move(xmod));
+        if(ROCKET_UNEXPECT(!this->do_can_push_mod0()))
+          return this->do_push_modifier_slow(Reference_Modifier::S_array_tail{ });
+
+        this->do_set_mod0<Reference_Modifier::index_array_tail>(0);
         return *this;
       }
 
     Reference&
     push_modifier_array_random(uint32_t seed)
       {
-        Reference_Modifier::S_array_random xmod = { seed };
-        this->m_mods.emplace_back(::std::move(xmod));
+        if(ROCKET_UNEXPECT(!this->do_can_push_mod0()))
+          return this->do_push_modifier_slow(Reference_Modifier::S_array_random{ seed });
+
+        this->do_set_mod0<Reference_Modifier::index_array_random>(seed);
         return *this;
       }
 
@@ -279,10 +455,15 @@ class Reference
         if(!has_value.test(this->index()))
           return *this;
 
+        if(ROCKET_EXPECT(this->m_mod0 != 0)) {
+          // Drop the only modifier.
+          this->clear_modifiers();
+          return *this;
+        }
+
         if(this->m_mods.empty()) {
           // Set to `null`.
-          this->m_value = nullopt;
-          this->m_index = index_temporary;
+          this->set_temporary(nullopt);
           return *this;
         }
 
@@ -297,7 +478,7 @@ class Reference
     const Value&
     dereference_readonly() const
       {
-        return ROCKET_EXPECT(this->is_temporary() && this->m_mods.empty())
+        return ROCKET_EXPECT(this->is_temporary() && (this->count_modifiers() == 0))
             ? this->m_value
             : this->do_dereference_readonly_slow();
       }
@@ -306,7 +487,7 @@ class Reference
     Value&
     mut_temporary()
       {
-        return ROCKET_EXPECT(this->is_temporary() && this->m_mods.empty())
+        return ROCKET_EXPECT(this->is_temporary() && (this->count_modifiers() == 0))
             ? this->m_value
             : this->do_mutate_into_temporary_slow();
       }
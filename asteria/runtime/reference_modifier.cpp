@@ -10,12 +10,11 @@ namespace asteria {
 
 const Value*
 Reference_Modifier::
-apply_read_opt(const Value& parent) const
+apply_read_opt(const Value& parent, Index index, int64_t ival, const phsh_string* key)
   {
-    switch(this->index()) {
+    switch(index) {
       case index_array_index: {
         // Get the element at the given index.
-        const auto& altr = this->m_stor.as<index_array_index>();
         if(parent.is_null()) {
           // Elements of null values are also null values.
           return nullptr;
@@ -23,10 +22,10 @@ apply_read_opt(const Value& parent) const
         else if(!parent.is_array())
           ASTERIA_THROW_RUNTIME_ERROR((
               "Integer subscript not applicable (parent type was `$1`; index was `$2`)"),
-              describe_type(parent.type()), altr.index);
+              describe_type(parent.type()), ival);
 
         const auto& arr = parent.as_array();
-        auto w = wrap_index(altr.index, arr.size());
+        auto w = wrap_index(ival, arr.size());
         if(w.nprepend | w.nappend)
           return nullptr;
 
@@ -35,7 +34,6 @@ apply_read_opt(const Value& parent) const
 
       case index_object_key: {
         // Get the value with the given key.
-        const auto& altr = this->m_stor.as<index_object_key>();
         if(parent.is_null()) {
           // Members of null values are also null values.
           return nullptr;
@@ -43,10 +41,10 @@ apply_read_opt(const Value& parent) const
         else if(!parent.is_object())
           ASTERIA_THROW_RUNTIME_ERROR((
               "String subscript not applicable (parent type was `$1`; key was `$2`)"),
-              describe_type(parent.type()), altr.key);
+              describe_type(parent.type()), *key);
 
         const auto& obj = parent.as_object();
-        return obj.ptr(altr.key);
+        return obj.ptr(*key);
       }
 
       case index_array_head: {
@@ -87,7 +85,6 @@ apply_read_opt(const Value& parent) const
 
       case index_array_random: {
         // Get a random element.
-        const auto& altr = this->m_stor.as<index_array_random>();
         if(parent.is_null()) {
           // Elements of null values are also null values.
           return nullptr;
@@ -103,25 +100,24 @@ apply_read_opt(const Value& parent) const
         if(bptr == eptr)
           return nullptr;
 
-        auto mptr = ::rocket::get_probing_origin(bptr, eptr, altr.seed);
+        auto mptr = ::rocket::get_probing_origin(bptr, eptr, static_cast<uint32_t>(ival));
         return mptr;
       }
 
       default:
         ASTERIA_TERMINATE((
             "Invalid reference modifier type (index `$1`)"),
-            this->index());
+            index);
     }
   }
 
 Value*
 Reference_Modifier::
-apply_write_opt(Value& parent) const
+apply_write_opt(Value& parent, Index index, int64_t ival, const phsh_string* key)
   {
-    switch(this->index()) {
+    switch(index) {
       case index_array_index: {
         // Get the element at the given index.
-        const auto& altr = this->m_stor.as<index_array_index>();
         if(parent.is_null()) {
           // Elements of null values are also null values.
           return nullptr;
@@ -129,10 +125,10 @@ apply_write_opt(Value& parent) const
         else if(!parent.is_array())
           ASTERIA_THROW_RUNTIME_ERROR((
               "Integer subscript not applicable (parent type was `$1`; index was `$2`)"),
-              describe_type(parent.type()), altr.index);
+              describe_type(parent.type()), ival);
 
         auto& arr = parent.mut_array();
-        auto w = wrap_index(altr.index, arr.size());
+        auto w = wrap_index(ival, arr.size());
         if(w.nprepend | w.nappend)
           return nullptr;
 
@@ -141,7 +137,6 @@ apply_write_opt(Value& parent) const
 
       case index_object_key: {
         // Get the value with the given key.
-        const auto& altr = this->m_stor.as<index_object_key>();
         if(parent.is_null()) {
           // Members of null values are also null values.
           return nullptr;
@@ -149,10 +144,10 @@ apply_write_opt(Value& parent) const
         else if(!parent.is_object())
           ASTERIA_THROW_RUNTIME_ERROR((
               "String subscript not applicable (parent type was `$1`; key was `$2`)"),
-              describe_type(parent.type()), altr.key);
+              describe_type(parent.type()), *key);
 
         auto& obj = parent.mut_object();
-        return obj.mut_ptr(altr.key);
+        return obj.mut_ptr(*key);
       }
 
       case index_array_head: {
@@ -193,7 +188,6 @@ apply_write_opt(Value& parent) const
 
       case index_array_random: {
         // Get a random element.
-        const auto& altr = this->m_stor.as<index_array_random>();
         if(parent.is_null()) {
           // Elements of null values are also null values.
           return nullptr;
@@ -209,25 +203,24 @@ apply_write_opt(Value& parent) const
         if(bptr == eptr)
           return nullptr;
 
-        auto mptr = ::rocket::get_probing_origin(bptr, eptr, altr.seed);
+        auto mptr = ::rocket::get_probing_origin(bptr, eptr, static_cast<uint32_t>(ival));
         return mptr;
       }
 
       default:
         ASTERIA_TERMINATE((
             "Invalid reference modifier type (index `$1`)"),
-            this->index());
+            index);
     }
   }
 
 Value&
 Reference_Modifier::
-apply_open(Value& parent) const
+apply_open(Value& parent, Index index, int64_t ival, const phsh_string* key)
   {
-    switch(this->index()) {
+    switch(index) {
       case index_array_index: {
         // Get the element at the given index.
-        const auto& altr = this->m_stor.as<index_array_index>();
         if(parent.is_null()) {
           // Empty arrays are created if null values are encountered.
           parent = V_array();
@@ -235,10 +228,10 @@ apply_open(Value& parent) const
         else if(!parent.is_array())
           ASTERIA_THROW_RUNTIME_ERROR((
               "Integer subscript not applicable (parent type was `$1`; index was `$2`)"),
-              describe_type(parent.type()), altr.index);
+              describe_type(parent.type()), ival);
 
         auto& arr = parent.mut_array();
-        auto w = wrap_index(altr.index, arr.size());
+        auto w = wrap_index(ival, arr.size());
         if(w.nprepend)
           arr.insert(arr.begin(), w.nprepend);
         else if(w.nappend)
@@ -249,7 +242,6 @@ apply_open(Value& parent) const
 
       case index_object_key: {
         // Get the value with the given key.
-        const auto& altr = this->m_stor.as<index_object_key>();
         if(parent.is_null()) {
           // Empty objects are created if null values are encountered.
           parent = V_object();
@@ -257,10 +249,10 @@ apply_open(Value& parent) const
         else if(!parent.is_object())
           ASTERIA_THROW_RUNTIME_ERROR((
               "String subscript not applicable (parent type was `$1`; key was `$2`)"),
-              describe_type(parent.type()), altr.key);
+              describe_type(parent.type()), *key);
 
         auto& obj = parent.mut_object();
-        return obj.try_emplace(altr.key).first->second;
+        return obj.try_emplace(*key).first->second;
       }
 
       case index_array_head: {
@@ -305,7 +297,6 @@ apply_open(Value& parent) const
 
       case index_array_random: {
         // Get a random element.
-        const auto& altr = this->m_stor.as<index_array_random>();
         if(parent.is_null()) {
           // Empty arrays are created if null values are encountered.
           parent = V_array();
@@ -322,25 +313,24 @@ apply_open(Value& parent) const
           ASTERIA_THROW_RUNTIME_ERROR((
               "Cannot write to random element of an empty array"));
 
-        auto mptr = ::rocket::get_probing_origin(bptr, eptr, altr.seed);
+        auto mptr = ::rocket::get_probing_origin(bptr, eptr, static_cast<uint32_t>(ival));
         return *mptr;
       }
 
       default:
         ASTERIA_TERMINATE((
             "Invalid reference modifier type (index `$1`)"),
-            this->index());
+            index);
     }
   }
 
 Value
 Reference_Modifier::
-apply_unset(Value& parent) const
+apply_unset(Value& parent, Index index, int64_t ival, const phsh_string* key)
   {
-    switch(this->index()) {
+    switch(index) {
       case index_array_index: {
         // Get the element at the given index.
-        const auto& altr = this->m_stor.as<index_array_index>();
         if(parent.is_null()) {
           // Elements of null values are also null values.
           return nullopt;
@@ -348,10 +338,10 @@ apply_unset(Value& parent) const
         else if(!parent.is_array())
           ASTERIA_THROW_RUNTIME_ERROR((
               "Integer subscript not applicable (parent type was `$1`; index was `$2`)"),
-              describe_type(parent.type()), altr.index);
+              describe_type(parent.type()), ival);
 
         auto& arr = parent.mut_array();
-        auto w = wrap_index(altr.index, arr.size());
+        auto w = wrap_index(ival, arr.size());
         if(w.nprepend | w.nappend)
           return nullopt;
 
@@ -362,7 +352,6 @@ apply_unset(Value& parent) const
 
       case index_object_key: {
         // Get the value with the given key.
-        const auto& altr = this->m_stor.as<index_object_key>();
         if(parent.is_null()) {
           // Members of null values are also null values.
           return nullopt;
@@ -370,10 +359,10 @@ apply_unset(Value& parent) const
         else if(!parent.is_object())
           ASTERIA_THROW_RUNTIME_ERROR((
               "String subscript not applicable (parent type was `$1`; key was `$2`)"),
-              describe_type(parent.type()), altr.key);
+              describe_type(parent.type()), *key);
 
         auto& obj = parent.mut_object();
-        auto it = obj.find(altr.key);
+        auto it = obj.find(*key);
         if(it == obj.end())
           return nullopt;
 
@@ -424,7 +413,6 @@ apply_unset(Value& parent) const
 
       case index_array_random: {
         // Get a random element.
-        const auto& altr = this->m_stor.as<index_array_random>();
         if(parent.is_null()) {
           // Elements of null values are also null values.
           return nullopt;
@@ -440,7 +428,7 @@ apply_unset(Value& parent) const
         if(bptr == eptr)
           return nullopt;
 
-        auto mptr = ::rocket::get_probing_origin(bptr, eptr, altr.seed);
+        auto mptr = ::rocket::get_probing_origin(bptr, eptr, static_cast<uint32_t>(ival));
         auto val = ::std::move(*mptr);
         arr.erase(static_cast<size_t>(mptr - bptr), 1);
         return val;
@@ -449,8 +437,36 @@ apply_unset(Value& parent) const
       default:
         ASTERIA_TERMINATE((
             "Invalid reference modifier type (index `$1`)"),
-            this->index());
+            index);
     }
   }
 
+const Value*
+Reference_Modifier::
+apply_read_opt(const Value& parent) const
+  {
+    return apply_read_opt(parent, this->index(), this->do_get_ival(), this->do_get_key_opt());
+  }
+
+Value*
+Reference_Modifier::
+apply_write_opt(Value& parent) const
+  {
+    return apply_write_opt(parent, this->index(), this->do_get_ival(), this->do_get_key_opt());
+  }
+
+Value&
+Reference_Modifier::
+apply_open(Value& parent) const
+  {
+    return apply_open(parent, this->index(), this->do_get_ival(), this->do_get_key_opt());
+  }
+
+Value
+Reference_Modifier::
+apply_unset(Value& parent) const
+  {
+    return apply_unset(parent, this->index(), this->do_get_ival(), this->do_get_key_opt());
+  }
+
 }  // namespace asteria
@@ -79,6 +79,25 @@ class Reference_Modifier
         return *this;
       }
 
+  private:
+    int64_t
+    do_get_ival() const noexcept
+      {
+        if(auto ptr = this->m_stor.ptr<index_array_index>())
+          return ptr->index;
+        if(auto ptr = this->m_stor.ptr<index_array_random>())
+          return ptr->seed;
+        return 0;
+      }
+
+    const phsh_string*
+    do_get_key_opt() const noexcept
+      {
+        if(auto ptr = this->m_stor.ptr<index_object_key>())
+          return &(ptr->key);
+        return nullptr;
+      }
+
   public:
     Index
     index() const noexcept
@@ -112,6 +131,25 @@ class Reference_Modifier
     is_array_random() const noexcept
       { return this->index() == index_array_random;  }
 
+    // Apply a modifier that is given in parts on a value. `ival` is the index
+    // or the seed, and `key` is the key, according to `index`. `Reference`
+    // stores its first modifier this way.
+    static
+    const Value*
+    apply_read_opt(const Value& parent, Index index, int64_t ival, const phsh_string* key);
+
+    static
+    Value*
+    apply_write_opt(Value& parent, Index index, int64_t ival, const phsh_string* key);
+
+    static
+    Value&
+    apply_open(Value& parent, Index index, int64_t ival, const phsh_string* key);
+
+    static
+    Value
+    apply_unset(Value& parent, Index index, int64_t ival, const phsh_string* key);
+
     // Apply this modifier on a value.
     const Value*
     apply_read_opt(const Value& parent) const;
@@ -44,6 +44,33 @@ do_insert_frame(Backtrace_Frame&& new_frm)
     this->m_frames.insert(this->m_ins_at, ::std::move(new_frm));
     this->m_ins_at++;
 
+    // The message will be rebuilt when it is requested.
+    this->m_composed.store(false);
+  }
+
+void
+Runtime_Error::
+do_compose_message() const noexcept
+  {
+    // Check again, as the message may have been composed by another thread.
+    ::rocket::mutex::unique_lock lock(this->m_fmt_mutex);
+    if(this->m_composed.load())
+      return;
+
+    try {
+      this->do_compose_message_unlocked();
+    }
+    catch(exception& /*stdex*/) {
+      // Leave the message incomplete. It is not composed again, as other
+      // threads may be reading it.
+    }
+    this->m_composed.store(true);
+  }
+
+void
+Runtime_Error::
+do_compose_message_unlocked() const
+  {
     // Rebuild the message using new frames. The storage may be reused.
     // Strings are written verbatim. All the others are formatted.
     this->m_fmt.clear_string();
@@ -7,6 +7,7 @@
 #include "../fwd.hpp"
 #include "backtrace_frame.hpp"
 #include "../../rocket/tinyfmt_str.hpp"
+#include "../../rocket/mutex.hpp"
 #include <exception>
 namespace asteria {
 
@@ -23,7 +24,14 @@ class Runtime_Error
     cow_vector<Backtrace_Frame> m_frames;
     size_t m_ins_at = 0;  // where to insert new frames
 
-    ::rocket::tinyfmt_str m_fmt;  // human-readable message
+    // The human-readable message is composed only when it is requested, as
+    // frames are pushed while the stack is being unwound, and exceptions that
+    // are caught by scripts are usually not printed. As an exception may be
+    // shared by multiple threads, composition is guarded by a mutex. Copies
+    // don't share messages, and will compose their own ones.
+    mutable ::rocket::mutex m_fmt_mutex;
+    mutable ::rocket::tinyfmt_str m_fmt;
+    mutable atomic_acq_rel<bool> m_composed;
 
   public:
     template<typename XValT>
@@ -49,12 +57,37 @@ class Runtime_Error
     void
     do_insert_frame(Backtrace_Frame&& new_frm);
 
+    void
+    do_compose_message() const noexcept;
+
+    void
+    do_compose_message_unlocked() const;
+
   public:
-    ASTERIA_COPYABLE_DESTRUCTOR(Runtime_Error);
+    Runtime_Error(const Runtime_Error& other) noexcept
+      : m_value(other.m_value), m_frames(other.m_frames),
+        m_ins_at(other.m_ins_at)
+      { }
+
+    Runtime_Error&
+    operator=(const Runtime_Error& other) & noexcept
+      {
+        this->m_value = other.m_value;
+        this->m_frames = other.m_frames;
+        this->m_ins_at = other.m_ins_at;
+        this->m_composed.store(false);
+        return *this;
+      }
+
+    ~Runtime_Error();
 
     const char*
     what() const noexcept override
-      { return this->m_fmt.c_str();  }
+      {
+        if(!this->m_composed.load())
+          this->do_compose_message();
+        return this->m_fmt.c_str();
+      }
 
     const Value&
     value() const noexcept
@@ -3,6 +3,7 @@
 
 #include "../precompiled.ipp"
 #include "variable.hpp"
+#include "../llds/variable_slab.hpp"
 #include "../utils.hpp"
 namespace asteria {
 
@@ -11,4 +12,34 @@ Variable::
   {
   }
 
+void*
+Variable::
+operator new(size_t size)
+  {
+    ROCKET_ASSERT(size == sizeof(Variable));
+    return Variable_Slab::allocate_unowned();
+  }
+
+void*
+Variable::
+operator new(size_t size, Variable_Slab& slab)
+  {
+    ROCKET_ASSERT(size == sizeof(Variable));
+    return slab.allocate();
+  }
+
+void
+Variable::
+operator delete(void* ptr) noexcept
+  {
+    Variable_Slab::deallocate(ptr);
+  }
+
+void
+Variable::
+operator delete(void* ptr, Variable_Slab& /*slab*/) noexcept
+  {
+    Variable_Slab::deallocate(ptr);
+  }
+
 }  // namespace asteria
@@ -21,9 +21,14 @@ class Variable final
 
   private:
     State m_state = state_invalid;
+    uint8_t m_gc_list = 0;  // ID of the list that owns this variable
     Value m_value;
     long m_gc_ref;  // uninitialized by default
 
+    // These are links in a list of the garbage collector.
+    Variable* m_gc_prev;
+    Variable* m_gc_next;
+
   public:
     explicit
     Variable() noexcept
@@ -32,6 +37,25 @@ class Variable final
   public:
     ASTERIA_NONCOPYABLE_DESTRUCTOR(Variable);
 
+    // Allocation functions
+    // Storage is taken from a slab if one is specified, and from the heap
+    // otherwise. Either can be freed with the same `operator delete`.
+    static
+    void*
+    operator new(size_t size);
+
+    static
+    void*
+    operator new(size_t size, Variable_Slab& slab);
+
+    static
+    void
+    operator delete(void* ptr) noexcept;
+
+    static
+    void
+    operator delete(void* ptr, Variable_Slab& slab) noexcept;
+
     // GC interfaces
     long
     get_gc_ref() const noexcept
@@ -41,6 +65,30 @@ class Variable final
     set_gc_ref(long ref) noexcept
       { this->m_gc_ref = ref;  }
 
+    uint8_t
+    get_gc_list() const noexcept
+      { return this->m_gc_list;  }
+
+    void
+    set_gc_list(uint8_t list) noexcept
+      { this->m_gc_list = list;  }
+
+    Variable*
+    get_gc_prev() const noexcept
+      { return this->m_gc_prev;  }
+
+    void
+    set_gc_prev(Variable* prev) noexcept
+      { this->m_gc_prev = prev;  }
+
+    Variable*
+    get_gc_next() const noexcept
+      { return this->m_gc_next;  }
+
+    void
+    set_gc_next(Variable* next) noexcept
+      { this->m_gc_next = next;  }
+
     // Accessors
     State
     state() const noexcept
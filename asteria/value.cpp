@@ -71,11 +71,13 @@ do_destroy_variant_slow() noexcept
         case type_array: {
           auto& altr = this->m_stor.mut<type_array>();
           if(altr.unique() && !altr.empty()) {
-            // Move raw bytes into `bytes`.
-            for(auto it = altr.mut_begin();  it != altr.end();  ++it) {
-              bytes.putn(it->m_bytes, sizeof(storage));
-              ::std::memset(it->m_bytes, 0, sizeof(storage));
-            }
+            // Move raw bytes of nested arrays and objects into `bytes`.
+            // Other elements will be destroyed with the array.
+            for(auto it = altr.mut_begin();  it != altr.end();  ++it)
+              if(it->type_mask() & (M_array | M_object)) {
+                bytes.putn(it->m_bytes, sizeof(storage));
+                ::std::memset(it->m_bytes, 0, sizeof(storage));
+              }
           }
           altr.~V_array();
           break;
@@ -84,11 +86,13 @@ do_destroy_variant_slow() noexcept
         case type_object: {
           auto& altr = this->m_stor.mut<type_object>();
           if(altr.unique() && !altr.empty()) {
-            // Move raw bytes into `bytes`.
-            for(auto it = altr.mut_begin();  it != altr.end();  ++it) {
-              bytes.putn(it->second.m_bytes, sizeof(storage));
-              ::std::memset(it->second.m_bytes, 0, sizeof(storage));
-            }
+            // Move raw bytes of nested arrays and objects into `bytes`.
+            // Other elements will be destroyed with the object.
+            for(auto it = altr.mut_begin();  it != altr.end();  ++it)
+              if(it->second.type_mask() & (M_array | M_object)) {
+                bytes.putn(it->second.m_bytes, sizeof(storage));
+                ::std::memset(it->second.m_bytes, 0, sizeof(storage));
+              }
           }
           altr.~V_object();
           break;
@@ -178,7 +178,7 @@ class basic_cow_string
 
   private:
     storage_handle m_sth;
-    const value_type* m_ptr;
+    const value_type* m_ptr;  // null if the string is stored in `m_sth`
     size_type m_len;
 
   public:
@@ -294,6 +294,15 @@ class basic_cow_string
       }
 
   private:
+    // Short strings are stored in the storage handle. As strings may be
+    // relocated bitwise, pointers to them are not stored; null pointers are
+    // stored instead. `ptr` shall have been obtained from `sth`.
+    void
+    do_set_ptr(const storage_handle& sth, const value_type* ptr) noexcept
+      {
+        this->m_ptr = sth.is_short_data(ptr) ? nullptr : ptr;
+      }
+
     basic_cow_string&
     do_deallocate() noexcept
       {
@@ -359,7 +368,7 @@ class basic_cow_string
         size_type slen = len - tpos - tlen;
         if(ROCKET_EXPECT(ptr && (n <= cap - len + tlen))) {
           traits_type::move(ptr + tpos + n, ptr + tpos + tlen, slen + 1);
-          this->m_ptr = ptr;  // note the storage might be unowned
+          this->do_set_ptr(this->m_sth, ptr);  // note the storage might be unowned
           this->m_len += n - tlen;
           return ptr + tpos;
         }
@@ -374,9 +383,9 @@ class basic_cow_string
 
         // Set the new storage up.
         this->m_sth.exchange_with(sth);
-        this->m_ptr = ptr;
+        this->do_set_ptr(sth, ptr);
         this->m_len += n - tlen;
-        return ptr + tpos;
+        return const_cast<value_type*>(this->data()) + tpos;
       }
 
     // These are generic implementations for `{{,r}find,find_{first,last}{,_not}_of}()` functions.
@@ -556,7 +565,7 @@ class basic_cow_string
 
         // Set the new storage up. The length is left intact.
         this->m_sth.exchange_with(sth);
-        this->m_ptr = ptr;
+        this->do_set_ptr(sth, ptr);
         return *this;
       }
 
@@ -580,7 +589,7 @@ class basic_cow_string
 
         // Set the new storage up. The length is left intact.
         this->m_sth.exchange_with(sth);
-        this->m_ptr = ptr;
+        this->do_set_ptr(sth, ptr);
         return *this;
       }
 
@@ -752,7 +761,7 @@ class basic_cow_string
         if(ROCKET_EXPECT(ptr && (n <= cap - len))) {
           traits_type::copy(ptr + len, s, n);
           traits_type::assign(*(ptr + len + n), value_type());
-          this->m_ptr = ptr;  // note the storage might be unowned
+          this->do_set_ptr(this->m_sth, ptr);  // note the storage might be unowned
           this->m_len += n;
           return *this;
         }
@@ -767,7 +776,7 @@ class basic_cow_string
 
         // Set the new storage up and increase the length.
         this->m_sth.exchange_with(sth);
-        this->m_ptr = ptr;
+        this->do_set_ptr(sth, ptr);
         this->m_len += n;
         return *this;
       }
@@ -785,7 +794,7 @@ class basic_cow_string
         if(ROCKET_EXPECT(ptr && (n <= cap - len))) {
           traits_type::assign(ptr + len, n, ch);
           traits_type::assign(*(ptr + len + n), value_type());
-          this->m_ptr = ptr;  // note the storage might be unowned
+          this->do_set_ptr(this->m_sth, ptr);  // note the storage might be unowned
           this->m_len += n;
           return *this;
         }
@@ -800,7 +809,7 @@ class basic_cow_string
 
         // Set the new storage up and increase the length.
         this->m_sth.exchange_with(sth);
-        this->m_ptr = ptr;
+        this->do_set_ptr(sth, ptr);
         this->m_len += n;
         return *this;
       }
@@ -842,7 +851,7 @@ class basic_cow_string
           for(auto it = ::std::move(first);  it != last;  ++it)
             traits_type::assign(*(ptr + len + n++), *it);
           traits_type::assign(*(ptr + len + n), value_type());
-          this->m_ptr = ptr;  // note the storage might be unowned
+          this->do_set_ptr(this->m_sth, ptr);  // note the storage might be unowned
           this->m_len += n;
           return *this;
         }
@@ -877,7 +886,7 @@ class basic_cow_string
 
         // Set the new storage up and increase the length.
         this->m_sth.exchange_with(sth);
-        this->m_ptr = ptr;
+        this->do_set_ptr(sth, ptr);
         this->m_len += n;
         return *this;
       }
@@ -1297,24 +1306,24 @@ class basic_cow_string
     constexpr
     const value_type*
     data() const noexcept
-      { return this->m_ptr;  }
+      { return ROCKET_EXPECT(this->m_ptr) ? this->m_ptr : this->m_sth.short_data();  }
 
     constexpr
     const value_type*
     c_str() const noexcept
-      { return this->m_ptr;  }
+      { return this->data();  }
 
     // N.B. This is a non-standard extension.
     const value_type*
     safe_c_str() const
       {
-        size_type clen = traits_type::length(this->m_ptr);
+        size_type clen = traits_type::length(this->data());
         if(clen != this->m_len)
           noadl::sprintf_and_throw<domain_error>(
                 "cow_string: embedded null character detected (at `%llu`)",
                 static_cast<unsigned long long>(clen));
 
-        return this->m_ptr;
+        return this->data();
       }
 
     // Get a pointer to mutable data. This function may throw `std::bad_alloc`.
@@ -1333,7 +1342,7 @@ class basic_cow_string
 
         // Reallocate the storage. The length is left intact.
         ptr = this->m_sth.reallocate_more(this->data(), this->size(), 0);
-        this->m_ptr = ptr;
+        this->do_set_ptr(this->m_sth, ptr);
         return ptr;
       }
 
@@ -1805,7 +1814,6 @@ struct basic_cow_string<charT, traitsT, allocT>::hash
     using result_type    = size_t;
     using argument_type  = basic_cow_string;
 
-    constexpr
     result_type
     operator()(const argument_type& str) const noexcept
       {
@@ -1814,7 +1822,6 @@ struct basic_cow_string<charT, traitsT, allocT>::hash
         return hf.finish();
       }
 
-    constexpr
     result_type
     operator()(const charT* s) const noexcept
       {
@@ -85,8 +85,28 @@ class storage_handle
     using storage_allocator = typename allocator_traits<allocator_type>::template rebind_alloc<storage>;
     using storage_pointer   = typename allocator_traits<storage_allocator>::pointer;
 
+    // Short strings are stored in place of the pointer, which is aligned, so
+    // its least significant bit is always zero. It's set to one to mark a short
+    // string. This requires at least one character for the tag and another one
+    // for the null terminator.
+    static constexpr size_t sso_nunits = sizeof(storage_pointer) / sizeof(value_type);
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    static constexpr size_t sso_tag_index = sso_nunits - 1;
+    static constexpr size_t sso_data_index = 0;
+#else
+    static constexpr size_t sso_tag_index = 0;
+    static constexpr size_t sso_data_index = 1;
+#endif
+
+  public:
+    static constexpr size_type sso_capacity = (is_pointer<storage_pointer>::value
+                                                && (sso_nunits >= 3)) ? (sso_nunits - 2) : 0;
+
   private:
-    storage_pointer m_qstor = nullptr;
+    union {
+      storage_pointer m_qstor = nullptr;
+      value_type m_sbuf[sso_nunits];
+    };
 
   public:
     explicit constexpr
@@ -106,9 +126,25 @@ class storage_handle
     operator=(const storage_handle&) = delete;
 
   private:
+    bool
+    do_is_short() const noexcept
+      {
+        return (sso_capacity != 0) && (this->m_sbuf[sso_tag_index] & 1);
+      }
+
+    value_type*
+    do_short_data() const noexcept
+      { return const_cast<value_type*>(this->short_data());  }
+
     void
     do_reset(storage_pointer qstor_new) noexcept
       {
+        // A short string owns nothing.
+        if(this->do_is_short()) {
+          this->m_qstor = qstor_new;
+          return;
+        }
+
         // Decrement the reference count with acquire-release semantics to prevent
         // races on `*qstor`.
         auto qstor = ::std::exchange(this->m_qstor, qstor_new);
@@ -147,6 +183,9 @@ class storage_handle
     bool
     unique() const noexcept
       {
+        if(this->do_is_short())
+          return true;
+
         auto qstor = this->m_qstor;
         if(!qstor)
           return false;
@@ -156,6 +195,9 @@ class storage_handle
     long
     use_count() const noexcept
       {
+        if(this->do_is_short())
+          return 1;
+
         auto qstor = this->m_qstor;
         if(!qstor)
           return 0;
@@ -166,6 +208,9 @@ class storage_handle
     size_type
     capacity() const noexcept
       {
+        if(this->do_is_short())
+          return sso_capacity;
+
         auto qstor = this->m_qstor;
         if(!qstor)
           return 0;
@@ -206,6 +251,9 @@ class storage_handle
     const value_type*
     data() const noexcept
       {
+        if(this->do_is_short())
+          return this->do_short_data();
+
         auto qstor = this->m_qstor;
         if(!qstor)
           return null_char;
@@ -215,6 +263,9 @@ class storage_handle
     value_type*
     mut_data_opt() noexcept
       {
+        if(this->do_is_short())
+          return this->do_short_data();
+
         auto qstor = this->m_qstor;
         if(!qstor || !qstor->nref.unique())
           return nullptr;
@@ -229,6 +280,19 @@ class storage_handle
         // The first part is copied from `src`. The second part is left uninitialized.
         size_type cap = this->check_size_add(len, add);
 
+        if((sso_capacity != 0) && (cap <= sso_capacity)) {
+          // Store the string in place. As `src` may point into this buffer, it
+          // has to be copied before the old storage is released.
+          value_type temp[sso_nunits];
+          traits_type::copy(temp, src, len);
+          this->do_reset(nullptr);
+
+          traits_type::assign(this->m_sbuf, sso_nunits, value_type());
+          traits_type::assign(this->m_sbuf[sso_tag_index], value_type(1));
+          traits_type::copy(this->do_short_data(), temp, len);
+          return this->do_short_data();
+        }
+
         // Allocate an array of `storage` large enough for a header + `cap` instances of `value_type`.
         auto nblk = storage::min_nblk_for_nchar(cap);
         storage_allocator st_alloc(this->as_allocator());
@@ -258,6 +322,15 @@ class storage_handle
     void
     share_with(const storage_handle& other) noexcept
       {
+        if(other.do_is_short()) {
+          // Copy the short string. `other` may be `*this`.
+          value_type temp[sso_nunits];
+          traits_type::copy(temp, other.m_sbuf, sso_nunits);
+          this->do_reset(nullptr);
+          traits_type::copy(this->m_sbuf, temp, sso_nunits);
+          return;
+        }
+
         auto qstor = other.m_qstor;
         if(qstor)
           qstor->nref.increment();
@@ -267,11 +340,28 @@ class storage_handle
     void
     exchange_with(storage_handle& other) noexcept
       { ::std::swap(this->m_qstor, other.m_qstor);  }
+
+    // Check whether `ptr` points into the short string in `*this`. Such
+    // pointers are not stored, so strings can be relocated bitwise.
+    bool
+    is_short_data(const value_type* ptr) const noexcept
+      {
+        auto off = reinterpret_cast<uintptr_t>(ptr) - reinterpret_cast<uintptr_t>(this->m_sbuf);
+        return off < sizeof(this->m_sbuf);
+      }
+
+    constexpr
+    const value_type*
+    short_data() const noexcept
+      { return this->m_sbuf + sso_data_index;  }
   };
 
 template<typename allocT, typename traitsT>
 constexpr typename allocT::value_type storage_handle<allocT, traitsT>::null_char[1];
 
+template<typename allocT, typename traitsT>
+constexpr typename storage_handle<allocT, traitsT>::size_type storage_handle<allocT, traitsT>::sso_capacity;
+
 // Implement relational operators.
 template<typename charT, typename traitsT>
 struct comparator
@@ -299,53 +389,121 @@ struct comparator
       }
   };
 
-// Implement the FNV-1a hash algorithm.
+// Implement a 64-bit hash algorithm which consumes 8 bytes per step. Each
+// word is mixed with a multiply and a rotation, and the result is finalized
+// with an avalanche, like the one of xxHash64. Characters are hashed by their
+// object representations, so hash values may differ across platforms.
 template<typename charT, typename traitsT>
 class basic_hasher
   {
   private:
-    static constexpr char32_t xoffset = 0x811C9DC5;
-    static constexpr char32_t xprime = 0x1000193;
-    char32_t m_reg = xoffset;
+    static constexpr uint64_t xprime1 = 0x9E3779B185EBCA87;
+    static constexpr uint64_t xprime2 = 0xC2B2AE3D27D4EB4F;
+    static constexpr uint64_t xprime3 = 0x165667B19E3779F9;
+    static constexpr uint64_t xprime4 = 0x85EBCA77C2B2AE63;
+    static constexpr uint64_t xoffset = 0x27D4EB2F165667C5;
+
+    uint64_t m_reg = xoffset;
+    uint64_t m_word = 0;    // pending bytes, in little-endian order
+    uint64_t m_nbytes = 0;  // total number of bytes
+
+  private:
+    static constexpr
+    uint64_t
+    do_rotl(uint64_t x, int n) noexcept
+      { return (x << n) | (x >> (64 - n));  }
+
+    static
+    uint64_t
+    do_load_le64(const unsigned char* bp) noexcept
+      {
+        uint64_t word;
+        ::std::memcpy(&word, bp, 8);
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+        word = __builtin_bswap64(word);
+#endif
+        return word;
+      }
+
+    void
+    do_round(uint64_t word) noexcept
+      {
+        this->m_reg ^= do_rotl(word * xprime2, 31) * xprime1;
+        this->m_reg = do_rotl(this->m_reg, 27) * xprime1 + xprime4;
+      }
+
+    void
+    do_append_bytes(const unsigned char* bp, size_t n) noexcept
+      {
+        size_t ntail = this->m_nbytes % 8;
+        this->m_nbytes += n;
+
+        if(ntail != 0) {
+          // Complete the pending word first.
+          while((ntail != 8) && (n != 0)) {
+            this->m_word |= static_cast<uint64_t>(*(bp++)) << ntail * 8;
+            ntail ++;
+            n --;
+          }
+
+          if(ntail != 8)
+            return;
+
+          this->do_round(this->m_word);
+          this->m_word = 0;
+        }
+
+        while(n >= 8) {
+          this->do_round(do_load_le64(bp));
+          bp += 8;
+          n -= 8;
+        }
+
+        for(size_t k = 0;  k != n;  ++k)
+          this->m_word |= static_cast<uint64_t>(bp[k]) << k * 8;
+      }
 
   public:
-    constexpr
     basic_hasher&
     append(charT c) noexcept
       {
-        char32_t word = static_cast<char32_t>(c);
-        for(unsigned k = 0;  k < sizeof(charT);  ++k)
-          this->m_reg = (this->m_reg ^ ((word >> k * 8) & 0xFF)) * xprime;
+        this->do_append_bytes(reinterpret_cast<const unsigned char*>(&c), sizeof(c));
         return *this;
       }
 
-    constexpr
     basic_hasher&
     append(const charT* s, size_t n)
       {
-        const charT* sp = s;
-        while(sp != s + n)
-          this->append(*(sp++));
+        this->do_append_bytes(reinterpret_cast<const unsigned char*>(s), n * sizeof(charT));
         return *this;
       }
 
-    constexpr
     basic_hasher&
     append(const charT* s)
       {
-        const charT* sp = s;
-        while(!traitsT::eq(*sp, charT()))
-          this->append(*(sp++));
-        return *this;
+        return this->append(s, traitsT::length(s));
       }
 
-    constexpr
     size_t
     finish() noexcept
       {
-        char32_t reg = this->m_reg;
+        // Pad the pending word with zeroes. The length is mixed in, so
+        // trailing null characters are significant.
+        if(this->m_nbytes % 8 != 0)
+          this->do_round(this->m_word);
+
+        uint64_t reg = this->m_reg ^ this->m_nbytes * xprime3;
+
+        reg ^= reg >> 33;
+        reg *= xprime2;
+        reg ^= reg >> 29;
+        reg *= xprime3;
+        reg ^= reg >> 32;
+
         this->m_reg = xoffset;
-        return reg;
+        this->m_word = 0;
+        this->m_nbytes = 0;
+        return static_cast<size_t>(reg);
       }
   };
 
@@ -92,7 +92,10 @@ class basic_storage
                   static_cast<long long>(nused), static_cast<long long>(nadd),
                   static_cast<long long>(nmax));
 
-          size_type cap_new = (nused + nadd) | 0x1000;
+          // Grow the buffer geometrically, so a sequence of appends runs in
+          // linear time.
+          size_type nmore = noadl::min(noadl::max(nadd, nused / 2), nmax - nused);
+          size_type cap_new = (nused + nmore) | 0x1000;
           auto ptr_new = allocator_traits<allocator_type>::allocate(*this, cap_new);
           auto pbuf_new = noadl::unfancy(ptr_new);
 #ifdef ROCKET_DEBUG
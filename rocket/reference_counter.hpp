@@ -13,6 +13,12 @@ namespace rocket {
 template<typename valueT = long>
 class reference_counter;
 
+/* If `ROCKET_SINGLE_THREADED` is defined, counters are plain integers, and
+ * objects that share storage (such as copies of a string) must not be used
+ * by multiple threads, even for reading. This must be defined consistently
+ * in all translation units.
+**/
+
 template<typename valueT>
 class reference_counter
   {
@@ -23,7 +29,11 @@ class reference_counter
     using value_type  = valueT;
 
   private:
+#ifdef ROCKET_SINGLE_THREADED
+    value_type m_nref;
+#else
     ::std::atomic<value_type> m_nref;
+#endif
 
   public:
     constexpr
@@ -44,24 +54,34 @@ class reference_counter
 
     ~reference_counter()
       {
-        auto old = this->m_nref.load(memory_order_relaxed);
-        if(old > 1)
+        if(this->get() > 1)
           ::std::terminate();
       }
 
   public:
     bool
     unique() const noexcept
-      { return this->m_nref.load(memory_order_relaxed) == 1;  }
+      { return this->get() == 1;  }
 
     value_type
     get() const noexcept
-      { return this->m_nref.load(memory_order_relaxed);  }
+      {
+#ifdef ROCKET_SINGLE_THREADED
+        return this->m_nref;
+#else
+        return this->m_nref.load(memory_order_relaxed);
+#endif
+      }
 
     // Increment the counter only if it is non-zero, and return its new value.
     long
     try_increment() noexcept
       {
+#ifdef ROCKET_SINGLE_THREADED
+        if(this->m_nref == 0)
+          return 0;
+        return ++ this->m_nref;
+#else
         auto old = this->m_nref.load(memory_order_relaxed);
         for(;;)
           if(old == 0)
@@ -69,13 +89,18 @@ class reference_counter
           else if(this->m_nref.compare_exchange_weak(old, old + 1,
                                  memory_order_relaxed))
             return old + 1;
+#endif
       }
 
     // Increment the counter and return its new value.
     value_type
     increment() noexcept
       {
+#ifdef ROCKET_SINGLE_THREADED
+        auto old = this->m_nref ++;
+#else
         auto old = this->m_nref.fetch_add(1, memory_order_relaxed);
+#endif
         ROCKET_ASSERT(old >= 1);
         return old + 1;
       }
@@ -87,7 +112,11 @@ class reference_counter
     value_type
     decrement() noexcept
       {
+#ifdef ROCKET_SINGLE_THREADED
+        auto old = this->m_nref --;
+#else
         auto old = this->m_nref.fetch_sub(1, memory_order_acq_rel);
+#endif
         ROCKET_ASSERT(old >= 1);
         return old - 1;
       }
@@ -0,0 +1,161 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2022, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/compiler/token_stream.hpp"
+#include "../asteria/compiler/statement_sequence.hpp"
+#include "../asteria/compiler/statement.hpp"
+#include "../asteria/runtime/air_optimizer.hpp"
+#include "../asteria/runtime/global_context.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    // Check that each pass does what it is expected to.
+    ::rocket::tinybuf_str cbuf;
+    cbuf.set_string(sref(
+      R"__(
+        var x = 1 + 2;
+        if(x > 3) {
+          x = 0;
+        }
+        if(2 > 1) {
+          {
+            x = 4;
+          }
+        }
+        return x;
+        x = 5;
+      )__"), tinybuf::open_read);
+
+    Compiler_Options opts;
+    opts.optimization_level = 2;
+
+    Token_Stream tstrm(opts);
+    tstrm.reload(sref("dummy file"), 18, ::std::move(cbuf));
+    Statement_Sequence stmtq(opts);
+    stmtq.reload(::std::move(tstrm));
+
+    Global_Context global;
+    AIR_Optimizer optmz(opts);
+    optmz.reload(nullptr, { }, global, stmtq);
+
+    const auto& stats = optmz.get_statistics();
+    ASTERIA_TEST_CHECK(stats.nfolded == 3);
+    ASTERIA_TEST_CHECK(stats.npruned == 1);
+    ASTERIA_TEST_CHECK(stats.nremoved != 0);
+
+    // Blocks that declare nothing are not generated at all.
+    ASTERIA_TEST_CHECK(::rocket::none_of(optmz.get_code(),
+        [](const AIR_Node& node) { return node.index() == AIR_Node::index_execute_block;  }));
+
+    // Check that functions of the standard library are bound, and other
+    // members are not.
+    cbuf.set_string(sref(
+      R"__(
+        var x = std.math.exp(2, 4);
+        var y = std.math.pi * 2;
+        var z = std.string;
+      )__"), tinybuf::open_read);
+
+    tstrm.reload(sref("dummy file"), 56, ::std::move(cbuf));
+    stmtq.reload(::std::move(tstrm));
+    optmz.reload(nullptr, { }, global, stmtq);
+    ASTERIA_TEST_CHECK(optmz.get_statistics().nbound == 1);
+    ASTERIA_TEST_CHECK(::std::count_if(optmz.get_code().begin(), optmz.get_code().end(),
+        [](const AIR_Node& node) { return node.index() == AIR_Node::index_push_global_reference;  }) == 2);
+
+    // Check that optimized code behaves the same as unoptimized code.
+    for(int level = 0;  level <= 3;  ++level) {
+      Simple_Script code;
+      code.options().optimization_level = static_cast<int8_t>(level);
+      code.reload_string(
+        sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+          assert 1 + 2 * 3 == 7;
+          assert "a" + "b" == "ab";
+          assert typeof (1 + 1.5) == "real";
+          assert countof ("-" * 80) == 80;
+
+          try {
+            var x = 1 / 0;
+            assert false;
+          }
+          catch(e)
+            assert std.string.find(e, "division by zero") != null;
+
+          var r = 0;
+          if(1 < 2) {
+            var t = 5;
+            r = t;
+          }
+          else
+            r = 6;
+          assert r == 5;
+
+          func one() {
+            return 1;
+            assert false;
+          }
+          assert one() == 1;
+
+          var a = 10;
+          {
+            {
+              var b = 1;
+              {
+                {
+                  var g = func() = a + b;
+                  assert g() == 11;
+                }
+              }
+            }
+          }
+
+          func cap(p) {
+            return func() {
+              if(p + 1 == 3) {
+                {
+                  return a + p;
+                }
+              }
+              return -1;
+            };
+          }
+          assert cap(2)() == 12;
+          assert cap(3)() == -1;
+
+          assert std.math.exp(2, 4) == 16;
+          assert std.math.pi * 2 == std.math.pi + std.math.pi;
+          assert std.string.find("hello", "l") == 2;
+          assert std.nonexistent.x == null;
+          {
+            var std = { math = { sqrt = func(x) = x + 1 } };
+            assert std.math.sqrt(16) == 17;
+          }
+          try {
+            std.math.pi = 3;
+            assert false;
+          }
+          catch(e)
+            assert std.string.find(e, "Attempt to modify an immutable variable") != null;
+
+          try {
+            std.math.e += 1;
+            assert false;
+          }
+          catch(e)
+            assert std.string.find(e, "Attempt to modify an immutable variable") != null;
+
+          ref pi -> std.math.pi;
+          assert pi == std.math.pi;
+          ref math -> std.math;
+          assert math.exp(2, 3) == 8;
+
+///////////////////////////////////////////////////////////////////////////////
+        )__"));
+      code.execute();
+    }
+  }
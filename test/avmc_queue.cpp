@@ -0,0 +1,86 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2022, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/llds/avmc_queue.hpp"
+#include "../asteria/llds/reference_stack.hpp"
+#include "../asteria/runtime/executive_context.hpp"
+#include "../asteria/runtime/global_context.hpp"
+#include "../asteria/runtime/runtime_error.hpp"
+#include "../asteria/runtime/enums.hpp"
+using namespace ::asteria;
+
+static
+AIR_Status
+do_throw_if_marked(Executive_Context& /*ctx*/, const AVMC_Queue::Header* head)
+  {
+    if(head->uparam.u8v[0])
+      ASTERIA_THROW_RUNTIME_ERROR(("marked node"));
+    return air_status_next;
+  }
+
+static
+Source_Location
+do_execute_and_locate(Global_Context& global, const AVMC_Queue& queue)
+  {
+    Reference_Stack stack, alt_stack;
+    Executive_Context ctx(Executive_Context::M_defer(), global, stack, alt_stack,
+                          cow_bivector<Source_Location, AVMC_Queue>());
+    try {
+      queue.execute(ctx);
+    }
+    catch(Runtime_Error& except) {
+      ASTERIA_TEST_CHECK(except.count_frames() >= 2);
+      return except.frame(1).sloc();
+    }
+    return Source_Location();
+  }
+
+int main()
+  {
+    Global_Context global;
+    const cow_string files[] = { sref("first.ast"), sref("second.ast"), sref("third.ast") };
+
+    // Nodes from different files share interned file names, and their
+    // symbols shall survive reallocation and finalization.
+    for(int marked = 0;  marked < 300;  marked += 37) {
+      AVMC_Queue queue;
+      for(int k = 0;  k != 300;  ++k) {
+        AVMC_Queue::Uparam up;
+        up.u8v[0] = k == marked;
+        Source_Location sloc(files[k / 7 % 3], k + 1, k % 10);
+        queue.append(*do_throw_if_marked, &sloc, up);
+      }
+
+      auto sloc = do_execute_and_locate(global, queue);
+      ASTERIA_TEST_CHECK(sloc.file() == files[marked / 7 % 3]);
+      ASTERIA_TEST_CHECK(sloc.line() == marked + 1);
+      ASTERIA_TEST_CHECK(sloc.column() == marked % 10);
+
+      queue.finalize();
+      AVMC_Queue moved = ::std::move(queue);
+      sloc = do_execute_and_locate(global, moved);
+      ASTERIA_TEST_CHECK(sloc.file() == files[marked / 7 % 3]);
+      ASTERIA_TEST_CHECK(sloc.line() == marked + 1);
+      ASTERIA_TEST_CHECK(sloc.column() == marked % 10);
+    }
+
+    // Nodes without symbols may be mixed with nodes with symbols.
+    AVMC_Queue queue;
+    Source_Location sloc(files[1], 42, 7);
+    queue.append(*do_throw_if_marked, nullptr);
+    queue.append(*do_throw_if_marked, &sloc);
+    AVMC_Queue::Uparam up;
+    up.u8v[0] = true;
+    queue.append(*do_throw_if_marked, &sloc, up);
+    queue.finalize();
+
+    auto rsloc = do_execute_and_locate(global, queue);
+    ASTERIA_TEST_CHECK(rsloc.file() == files[1]);
+    ASTERIA_TEST_CHECK(rsloc.line() == 42);
+    ASTERIA_TEST_CHECK(rsloc.column() == 7);
+
+    queue.clear();
+    ASTERIA_TEST_CHECK(queue.empty());
+    ASTERIA_TEST_CHECK(do_execute_and_locate(global, queue).line() == -1);
+  }
@@ -0,0 +1,59 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2022, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+#include "../asteria/runtime/call_pool.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        var odd;
+        func even(n) { if(n == 0) return true;  return odd(n - 1);  }
+        odd = func(n) { if(n == 0) return false;  return even(n - 1);  };
+
+        for(var i = 0;  i < 100;  ++i) {
+          assert even(1000 + i * 2) == true;
+          assert odd(1000 + i * 2) == false;
+        }
+
+        // Arguments of tail calls are released after the chain returns.
+        var log = [];
+        func count(n, acc) {
+          defer log[$] = n;
+          if(n == 0) return acc;
+          return count(n - 1, acc + n);
+        }
+        assert count(50, 0) == 1275;
+        assert countof log == 51;
+        assert log[0] == 0;
+        assert log[-1] == 50;
+
+        func fail(n) {
+          if(n == 0) throw "boom";
+          return fail(n - 1);
+        }
+        try { fail(10);  assert false;  }
+          catch(e) assert e == "boom";
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    code.execute();
+
+    // Storage has been recycled, but the pool does not grow indefinitely.
+    auto& pool = code.global().call_pool();
+    ASTERIA_TEST_CHECK(pool.count_pooled_stacks() != 0);
+    ASTERIA_TEST_CHECK(pool.count_pooled_slots() != 0);
+    ASTERIA_TEST_CHECK(pool.count_pooled_ptc_arguments() != 0);
+    ASTERIA_TEST_CHECK(pool.count_pooled_ptc_arguments() <= 16);
+
+    pool.clear();
+    ASTERIA_TEST_CHECK(pool.count_pooled_stacks() == 0);
+    code.execute();
+    ASTERIA_TEST_CHECK(pool.count_pooled_stacks() != 0);
+  }
@@ -0,0 +1,85 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2022, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    // Closures share their code below level 3, and are rebound above it.
+    for(int level = 0;  level <= 3;  ++level) {
+      Simple_Script code;
+      code.options().optimization_level = static_cast<int8_t>(level);
+      code.reload_string(
+        sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+          var fs = [];
+          for(var i = 0;  i < 5;  ++i) {
+            var k = i * 10;
+            fs[$] = func() = k + i;
+          }
+          for(var i = 0;  i < 5;  ++i)
+            assert fs[i]() == i * 10 + 5;
+
+          var n = 1;
+          func counter() {
+            var c = 0;
+            return func() {
+              c += n;
+              return func(x) = c * x + n;
+            };
+          }
+          var c1 = counter();
+          var c2 = counter();
+          assert c1()(1) == 2;
+          assert c1()(1) == 3;
+          assert c2()(1) == 2;
+          n = 5;
+          assert c1()(2) == 19;
+          assert c2()(2) == 17;
+
+          var obj = {
+            val = 42,
+            get = func() {
+              var self = this;
+              return func() = self.val + __varg();
+            }
+          };
+          assert obj.get()() == 42;
+
+          var r = 1;
+          {
+            var g = func(a) {
+              defer r = a + r;
+              return func() = r;
+            };
+            assert g(3)() == 4;
+            assert r == 4;
+          }
+
+          func rec(x) { return (x <= 1) ? 1 : x * rec(x - 1);  }
+          assert rec(5) == 120;
+
+          func bad(x) {
+            switch(x) {
+            case 1:
+              var z = 1;
+            case 2:
+              return func() = z;
+            }
+          }
+          assert bad(1)() == 1;
+          try {
+            bad(2);
+            assert false;
+          }
+          catch(e)
+            assert std.string.find(e, "bypassed variable or reference `z`") != null;
+
+///////////////////////////////////////////////////////////////////////////////
+        )__"));
+      code.execute();
+    }
+  }
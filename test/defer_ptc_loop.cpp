@@ -0,0 +1,52 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2022, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+    var log = [ ];
+
+    func note(s) {
+      log[$] = s;
+    }
+    func tail(x) {
+      return x;
+    }
+
+    // The context of the loop body is reused by all iterations. Deferred
+    // expressions of the nested block and the body are both attached to the
+    // PTC wrapper.
+    func foo(n) {
+      for(var i = 0;  i < n;  ++i) {
+        var j = i;
+        defer note(j);
+        if(j == n - 1) {
+          var k = j;
+          defer note(k + 100);
+          return tail(k);  // proper tail call
+        }
+      }
+    }
+
+    assert foo(3) == 2;
+    assert log == [ 0, 1, 102, 2 ];
+
+    log = [ ];
+    for(var r = 0;  r < 3;  ++r) {
+      var s = r;
+      assert foo(2) == 1;
+    }
+    assert log == [ 0, 101, 1, 0, 101, 1, 0, 101, 1 ];
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    code.execute();
+  }
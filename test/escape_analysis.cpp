@@ -0,0 +1,142 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2022, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/compiler/token_stream.hpp"
+#include "../asteria/compiler/statement_sequence.hpp"
+#include "../asteria/runtime/air_optimizer.hpp"
+#include "../asteria/runtime/garbage_collector.hpp"
+#include "../asteria/runtime/global_context.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    // Check that only variables which don't escape are untracked.
+    ::rocket::tinybuf_str cbuf;
+    cbuf.set_string(sref(
+      R"__(
+        var a = 1;         // untracked
+        var b;             // captured
+        var c = [2];       // passed by reference
+        var d = 3;         // bound to a reference
+        var e;             // untracked
+        func f() { return b;  }
+        std.array.sort(->c);
+        ref r -> d;
+        e = f;
+        return a + d;
+      )__"), tinybuf::open_read);
+
+    Compiler_Options opts;
+    opts.optimization_level = 2;
+
+    Token_Stream tstrm(opts);
+    tstrm.reload(sref("dummy file"), 19, ::std::move(cbuf));
+    Statement_Sequence stmtq(opts);
+    stmtq.reload(::std::move(tstrm));
+
+    Global_Context global;
+    AIR_Optimizer optmz(opts);
+    optmz.reload(nullptr, { }, global, stmtq);
+    ASTERIA_TEST_CHECK(optmz.get_statistics().nuntracked == 3);  // a, e, f
+
+    // Local variables in loops shall not be tracked.
+    Simple_Script code;
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        std.system.gc_collect();
+        var n = std.system.gc_count_variables(0);
+
+        var sum = 0;
+        for(var i = 0;  i < 1000;  ++i) {
+          var x = i * 2;
+          var y;
+          y = [x, x + 1];
+          sum += y[1] - y[0];
+        }
+        assert sum == 1000;
+        assert std.system.gc_count_variables(0) == n;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    code.execute();
+
+    // Check that untracked variables behave the same as tracked ones.
+    for(int level = 0;  level <= 3;  ++level) {
+      code.options().optimization_level = static_cast<int8_t>(level);
+      code.reload_string(
+        sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+          func inc(x) { return x + 1;  }
+          func inc_ref(x) { return ++x;  }
+          func self(x) { return ->x;  }
+
+          var a = 1;
+          assert inc(a) == 2;
+          assert a == 1;
+          assert inc_ref(->a) == 2;
+          assert a == 2;
+
+          var b = 10;
+          ref rb -> b;
+          rb = 11;
+          assert b == 11;
+
+          var c = 20;
+          self(->c) = 21;
+          assert c == 21;
+
+          var d = [1, 2, 3];
+          var g = func() = d;
+          d[1] = 5;
+          assert g()[1] == 5;
+
+          var e = { x: 1 };
+          e.x += 2;
+          e.y = e.x * 2;
+          assert e.y == 6;
+
+          var h;
+          var k = h ?? 7;
+          assert k == 7;
+
+          var fs = [];
+          for(var i = 0;  i < 3;  ++i) {
+            var t = i * 10;
+            fs[$] = func() = t;
+          }
+          assert fs[0]() == 0;
+          assert fs[2]() == 20;
+
+          var [p, q] = [3, 4];
+          var { u } = { u: 5 };
+          assert p + q + u == 12;
+
+///////////////////////////////////////////////////////////////////////////////
+        )__"));
+      code.execute();
+    }
+
+    // Untracked variables are freed without collection.
+    const auto gcoll = code.global().garbage_collector();
+    gcoll->collect_variables();
+    size_t nvars = gcoll->count_tracked_variables(gc_generation_newest);
+    code.options().optimization_level = 2;
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        for(var i = 0;  i < 100;  ++i) {
+          var a = [i];
+          var b = { x: a };
+        }
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    code.execute();
+    ASTERIA_TEST_CHECK(gcoll->count_tracked_variables(gc_generation_newest) == nvars);
+  }
@@ -55,7 +55,7 @@ int main()
             }());
           }());
 
-          assert std.system.gc_collect() == 3;  // x, f, g
+          assert std.system.gc_collect() == 2;  // x, f; `g` is not tracked
 
 ///////////////////////////////////////////////////////////////////////////////
         )__"));
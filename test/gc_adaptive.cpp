@@ -0,0 +1,65 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2022, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+#include "../asteria/runtime/garbage_collector.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    const auto gcoll = code.global().garbage_collector();
+    ASTERIA_TEST_CHECK(gcoll->get_adaptive_thresholds() == false);
+    gcoll->set_adaptive_thresholds(true);
+    gcoll->set_threshold(gc_generation_newest, 400);
+    gcoll->set_threshold_bounds(gc_generation_newest, 50, 2000);
+    ASTERIA_TEST_CHECK(gcoll->get_min_threshold(gc_generation_newest) == 50);
+    ASTERIA_TEST_CHECK(gcoll->get_max_threshold(gc_generation_newest) == 2000);
+
+    // Most variables are garbage, so the newest generation shall be
+    // collected more often.
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        for(var i = 0;  i < 5000;  ++i)
+          (func() {
+            var a, b;
+            func p() { return b;  }
+            a = [p];
+            b = [a];
+          }());
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    code.execute();
+    ASTERIA_TEST_CHECK(gcoll->get_threshold(gc_generation_newest) == 50);
+
+    // Most variables survive, so the newest generation shall be collected
+    // less often.
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        var live = [];
+        for(var i = 0;  i < 5000;  ++i) {
+          var c = [i];
+          live[$] = func() = c;
+        }
+
+        assert countof live == 5000;
+        for(each k, v -> live)
+          assert v()[0] == k;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    code.execute();
+    ASTERIA_TEST_CHECK(gcoll->get_threshold(gc_generation_newest) == 2000);
+
+    // Thresholds are not adjusted if this is disabled.
+    gcoll->set_adaptive_thresholds(false);
+    gcoll->set_threshold(gc_generation_newest, 400);
+    code.execute();
+    ASTERIA_TEST_CHECK(gcoll->get_threshold(gc_generation_newest) == 400);
+  }
@@ -0,0 +1,88 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2022, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+#include "../asteria/runtime/garbage_collector.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        std.system.gc_set_threshold(0, 1000);
+        std.system.gc_set_threshold(1, 1000);
+        std.system.gc_set_threshold(2, 1000);
+
+        (func(){
+          (func(){
+            var x;
+            func f() { return x;  }
+            func g() { return f;  }
+            x = g;
+          }());
+        }());
+
+        // Collect the cycle in slices of one variable.
+        var n = 0;
+        for(var i = 0;  i < 1000;  ++i)
+          n += std.system.gc_step(1);
+        assert n == 2;  // x, f; `g` is not tracked
+
+        try { std.system.gc_step(0);  assert false;  }
+          catch(e) assert std.string.find(e, "Invalid budget") != null;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    code.execute();
+
+    // Let `create_variable()` drive collection in small slices, while the
+    // script keeps mutating live objects between them.
+    const auto gcoll = code.global().garbage_collector();
+    gcoll->set_step_budget(5);
+    ASTERIA_TEST_CHECK(gcoll->get_step_budget() == 5);
+
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        std.system.gc_set_threshold(0, 10);
+        std.system.gc_set_threshold(1, 70);
+        std.system.gc_set_threshold(2, 500);
+
+        var live = [];
+        for(var i = 0;  i < 3000;  ++i) {
+          (func() {
+            var a, b;
+            func p() { return b;  }
+            a = [p];
+            b = [a];
+          }());
+
+          var c = [i];
+          if(i % 7 == 0)
+            live[$] = func() = c;
+
+          if(i % 11 == 0)
+            live = std.array.rotate(live, 1);
+        }
+
+        assert countof live == 429;
+        for(each k, v -> live)
+          assert v()[0] % 7 == 0;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    code.execute();
+
+    size_t ntracked = 0;
+    for(auto gen : { gc_generation_newest, gc_generation_middle, gc_generation_oldest })
+      ntracked += gcoll->count_tracked_variables(gen);
+    ASTERIA_TEST_CHECK(ntracked < 3000);
+
+    gcoll->collect_variables();
+    ASTERIA_TEST_CHECK(gcoll->is_collecting() == false);
+  }
@@ -0,0 +1,65 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2022, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+#include "../asteria/runtime/garbage_collector.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        var s = std.system.gc_stats();
+        assert countof s.cycles == 3;
+        assert countof s.scanned == 3;
+        assert countof s.collected == 3;
+        assert countof s.promoted == 3;
+        assert countof s.pauses == 20;
+        assert typeof s.pool_hits == "integer";
+        assert typeof s.pool_misses == "integer";
+
+        var p = 0;
+        for(each k, v -> s.pauses)
+          p += v;
+
+        for(var i = 0;  i < 100;  ++i)
+          (func() {
+            var a, b;
+            func f() { return b;  }
+            a = [f];
+            b = [a];
+          }());
+
+        std.system.gc_collect();
+        var t = std.system.gc_stats();
+        for(var g = 0;  g < 3;  ++g) {
+          assert t.cycles[g] > s.cycles[g];
+          assert t.scanned[g] >= s.scanned[g];
+        }
+        assert t.collected[0] + t.collected[1] + t.collected[2] >= 100;  // b
+        assert t.pool_misses > s.pool_misses;
+
+        var q = 0;
+        for(each k, v -> t.pauses)
+          q += v;
+        assert q >= p + 3;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    code.execute();
+
+    // Variables that have been collected are reused.
+    const auto gcoll = code.global().garbage_collector();
+    gcoll->set_threshold(gc_generation_newest, 10);
+    uint64_t nhits = gcoll->get_statistics().pool_hits;
+    code.execute();
+    ASTERIA_TEST_CHECK(gcoll->get_statistics().pool_hits > nhits);
+
+    gcoll->clear_statistics();
+    ASTERIA_TEST_CHECK(gcoll->get_statistics().pool_misses == 0);
+    ASTERIA_TEST_CHECK(gcoll->get_statistics().cycles[0] == 0);
+  }
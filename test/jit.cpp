@@ -0,0 +1,87 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2022, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    // Native code shall behave the same as interpreted code.
+    for(int level = 0;  level <= 3;  ++level) {
+      Simple_Script code;
+      code.options().optimization_level = static_cast<int8_t>(level);
+      code.options().jit_compilation = true;
+      code.reload_string(
+        sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+          var sum = 0;
+          for(var i = 0;  i < 100;  ++i) {
+            if(i % 3 == 0)
+              continue;
+            if(i > 50)
+              break;
+            sum += i;
+          }
+          assert sum == 867;
+
+          func fib(n) {
+            if(n <= 1)
+              return n;
+            return fib(n - 1) + fib(n - 2);
+          }
+          assert fib(15) == 610;
+
+          var r = 0;
+          switch(sum % 5) {
+          case 1:
+            r = 1;
+            break;
+          case 2:
+            r = 2;
+          }
+          assert r == 2;
+
+          var log = [];
+          for(each k, v -> [ 5, 6, 7 ]) {
+            var t = k * v;
+            defer log[$] = t;
+          }
+          assert log == [ 0, 6, 14 ];
+
+          // Exceptions shall propagate through native code.
+          func throws(x) {
+            var y = x + 1;
+            throw y;
+          }
+          func calls(x) {
+            var z = throws(x);
+            return z;
+          }
+          try {
+            calls(41);
+            assert false;
+          }
+          catch(e)
+            assert e == 42;
+
+          try {
+            var q = 1 / 0;
+            assert false;
+          }
+          catch(e)
+            assert std.string.find(e, "division by zero") != null;
+
+          var fs = [];
+          for(var j = 0;  j < 3;  ++j) {
+            var k = j;
+            fs[$] = func() = k * 2;
+          }
+          assert fs[2]() == 4;
+
+///////////////////////////////////////////////////////////////////////////////
+        )__"));
+      code.execute();
+    }
+  }
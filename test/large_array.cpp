@@ -0,0 +1,50 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2022, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    // Large arrays that are copied on write shall be destroyed in linear
+    // time. This used to take several seconds per call.
+    Simple_Script code;
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        var a = [];
+        for(var i = 0;  i < 100000;  ++i)
+          a[i] = (i % 1000 == 0) ? [ i, { k: "element" } ] : i;
+
+        func update(arr, i, v) {
+          var r = arr;
+          r[i] = v;
+          return r;
+        }
+
+        var b = a;
+        for(var i = 0;  i < 100;  ++i)
+          b = update(b, i, -i);
+
+        assert countof b == 100000;
+        assert b[0] == 0;
+        assert b[99] == -99;
+        assert b[1000][1].k == "element";
+        assert a[0][0] == 0;
+        assert a[99] == 99;
+
+        for(var i = 0;  i < 100;  ++i)
+          b = std.array.replace_slice(b, i, 1, [ i ]);
+
+        assert countof b == 100000;
+        assert b[99] == 99;
+        assert b[2000][0] == 2000;
+        b = std.array.replace_slice(b, 10, 99990, [ "x", "y" ], 1);
+        assert b == [ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, "y" ];
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    code.execute();
+  }
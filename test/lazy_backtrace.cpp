@@ -0,0 +1,132 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2022, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/compiler/token_stream.hpp"
+#include "../asteria/compiler/statement_sequence.hpp"
+#include "../asteria/runtime/air_optimizer.hpp"
+#include "../asteria/runtime/global_context.hpp"
+#include "../asteria/runtime/runtime_error.hpp"
+#include "../asteria/simple_script.hpp"
+#include <thread>
+using namespace ::asteria;
+
+int main()
+  {
+    // Check that backtraces are built only for `catch` clauses that may
+    // reference `__backtrace`.
+    ::rocket::tinybuf_str cbuf;
+    cbuf.set_string(sref(
+      R"__(
+        try { throw 1;  } catch(e) { }                              // elided
+        try { throw 2;  } catch(e) { var b = __backtrace;  }        // used
+        try { throw 3;  } catch(e) { var f = func() = __backtrace;  }  // captured
+        try { throw 4;  } catch(e) {
+          try { throw 5;  } catch(e) { }                            // elided
+        }
+      )__"), tinybuf::open_read);
+
+    Compiler_Options opts;
+    opts.optimization_level = 2;
+
+    Token_Stream tstrm(opts);
+    tstrm.reload(sref("dummy file"), 19, ::std::move(cbuf));
+    Statement_Sequence stmtq(opts);
+    stmtq.reload(::std::move(tstrm));
+
+    Global_Context global;
+    AIR_Optimizer optmz(opts);
+    optmz.reload(nullptr, { }, global, stmtq);
+    ASTERIA_TEST_CHECK(optmz.get_statistics().nuntraced == 3);
+
+    // Check that backtraces are still complete where they are referenced.
+    Simple_Script code;
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func deep(n) {
+          if(n == 0)
+            throw "boom";
+          var r = deep(n - 1);
+          return r;
+        }
+
+        try
+          deep(5);
+        catch(e) {
+          assert e == "boom";
+          assert countof __backtrace >= 7;
+          assert __backtrace[0].frame == "throw statement";
+          assert __backtrace[0].value == "boom";
+        }
+
+        var f;
+        try
+          deep(3);
+        catch(e)
+          f = func() = __backtrace;
+        assert f()[0].frame == "throw statement";
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    code.execute();
+
+    // The message of an uncaught exception is composed when it is requested,
+    // and contains all frames.
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func deep(n) {
+          if(n == 0)
+            throw "boom";
+          var r = deep(n - 1);
+          return r;
+        }
+        deep(4);
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+
+    try {
+      code.execute();
+      ASTERIA_TEST_CHECK(false);
+    }
+    catch(Runtime_Error& except) {
+      cow_string msg = sref(except.what());
+      ASTERIA_TEST_CHECK(msg.find(sref("boom")) != cow_string::npos);
+      ASTERIA_TEST_CHECK(msg.find(sref("end of backtrace frames")) != cow_string::npos);
+
+      size_t nframes = 0;
+      for(size_t pos = msg.find(sref("\n  "));  pos != cow_string::npos;  pos = msg.find(pos + 1, sref("\n  ")))
+        nframes ++;
+      ASTERIA_TEST_CHECK(nframes >= except.count_frames());
+
+      // The message is not composed again.
+      ASTERIA_TEST_CHECK(except.what() == except.what());
+
+      // A copy composes its own message, which has the same contents.
+      Runtime_Error copy = except;
+      ASTERIA_TEST_CHECK(copy.what() != except.what());
+      ASTERIA_TEST_CHECK(msg == copy.what());
+    }
+
+    // The message of a shared exception may be requested by multiple threads
+    // at the same time.
+    try {
+      code.execute();
+      ASTERIA_TEST_CHECK(false);
+    }
+    catch(Runtime_Error& except) {
+      const char* results[4] = { };
+      ::std::thread threads[4];
+      for(size_t k = 0;  k != 4;  ++k)
+        threads[k] = ::std::thread([&, k] { results[k] = except.what();  });
+      for(size_t k = 0;  k != 4;  ++k)
+        threads[k].join();
+
+      for(size_t k = 0;  k != 4;  ++k)
+        ASTERIA_TEST_CHECK(results[k] == except.what());
+    }
+  }
@@ -0,0 +1,61 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2022, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        // Loop bodies that declare something share one context for all
+        // iterations. Check that each iteration still gets its own variables.
+        var log = [];
+        var fs = [];
+        for(var i = 0;  i < 3;  ++i) {
+          var z = i * 10;
+          if(i == 1)
+            continue;
+          defer log[$] = z;
+          fs[$] = func() = z;
+        }
+        assert log == [ 0, 20 ];
+        assert fs[0]() == 0;
+        assert fs[1]() == 20;
+
+        // Scope-free bodies are executed in the enclosing context.
+        var sum = 0;
+        for(each k, v -> [ 1, 2, 3 ]) {
+          sum += k * v;
+          { sum += 1; }
+        }
+        assert sum == 11;
+
+        // The mapped reference must stay valid across bodies that declare
+        // variables and capture them.
+        var arr = [ 1, 2, 3, 4 ];
+        fs = [];
+        for(each k, v -> arr) {
+          var a = v, b = a + 1, c = b + 1, d = c + 1, e = d + 1;
+          fs[$] = func() = a + e;
+          v = e;
+        }
+        assert arr == [ 5, 6, 7, 8 ];
+        assert fs[3]() == 12;
+
+        var n = 0;
+        do {
+          var m = n;
+          n = m + 1;
+        }
+        while(n < 5);
+        assert n == 5;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    code.execute();
+  }
@@ -0,0 +1,53 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2022, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    // Member access nodes look keys up only when references are dereferenced.
+    // Check that they find the right members after objects change, and that
+    // invalid parents are still reported at once.
+    Simple_Script code;
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func get_x(o) { return o.x;  }
+
+        var objs = [
+          { x = 1 },
+          { a = 2, b = 3, x = 4 },
+          { y = 5 },
+          null,
+          { x = 6, y = 7, z = 8, w = 9, v = 10, u = 11, t = 12, s = 13 },
+        ];
+        var r = [];
+        for(var k = 0;  k < 2;  ++k)
+          for(each i, o -> objs)
+            r[$] = get_x(o);
+        assert r == [ 1, 4, null, null, 6, 1, 4, null, null, 6 ];
+
+        var obj = { x = 1 };
+        for(var i = 0;  i < 20;  ++i) {
+          obj.x = get_x(obj) + 1;
+          obj[std.numeric.format(i)] = i;
+          unset obj[std.numeric.format(i - 1)];
+        }
+        assert obj.x == 21;
+        unset obj.x;
+        assert get_x(obj) == null;
+
+        assert std.string.find("abc", "c") == 2;
+        assert std.string.find("abc", "d") == null;
+
+        var n = 42;
+        try { n.x;  assert false;  }
+          catch(e) assert std.string.find(e, "String subscript not applicable") != null;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    code.execute();
+  }
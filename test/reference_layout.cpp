@@ -0,0 +1,176 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2022, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/runtime/reference.hpp"
+#include "../asteria/runtime/variable.hpp"
+using namespace ::asteria;
+
+static size_t alloc_count;
+
+void* operator new(size_t cb)
+  {
+    auto ptr = ::std::malloc(cb);
+    if(!ptr)
+      throw ::std::bad_alloc();
+
+    alloc_count ++;
+    return ptr;
+  }
+
+void operator delete(void* ptr) noexcept
+  {
+    ::std::free(ptr);
+  }
+
+void operator delete(void* ptr, size_t) noexcept
+  {
+    ::operator delete(ptr);
+  }
+
+int main()
+  {
+    // A reference is not much larger than the value it holds.
+    ASTERIA_TEST_CHECK(sizeof(Reference) <= sizeof(Value) + sizeof(void*) * 2);
+
+    // Switch between all kinds of references.
+    auto var = ::rocket::make_refcnt<Variable>();
+    var->initialize(cow_string(sref("variable value, which is long")));
+
+    Reference ref;
+    ASTERIA_TEST_CHECK(ref.is_invalid());
+    ref.set_temporary(cow_string(sref("temporary value, which is long")));
+    ASTERIA_TEST_CHECK(ref.dereference_readonly().as_string() == sref("temporary value, which is long"));
+    ref.set_variable(var);
+    ASTERIA_TEST_CHECK(ref.get_variable_opt() == var);
+    ASTERIA_TEST_CHECK(ref.dereference_readonly().as_string() == sref("variable value, which is long"));
+    ref.set_variable(var);
+    ASTERIA_TEST_CHECK(var.use_count() == 2);
+
+    Reference ref2 = ref;
+    ASTERIA_TEST_CHECK(var.use_count() == 3);
+    ref2.set_void();
+    ASTERIA_TEST_CHECK(ref2.is_void());
+    ASTERIA_TEST_CHECK(var.use_count() == 2);
+    ref2 = ref;
+    ASTERIA_TEST_CHECK(var.use_count() == 3);
+    ref2.swap(ref);
+    ASTERIA_TEST_CHECK(var.use_count() == 3);
+
+    // The value is copied before the variable is released.
+    ref.set_temporary(var->get_value());
+    ref2.set_temporary(var->get_value());
+    ASTERIA_TEST_CHECK(var.use_count() == 1);
+    ASTERIA_TEST_CHECK(ref.dereference_readonly().as_string() == sref("variable value, which is long"));
+    ref2 = ::std::move(ref);
+    ASTERIA_TEST_CHECK(ref2.dereference_readonly().as_string() == sref("variable value, which is long"));
+
+    // Removing the last modifier of a variable yields `null`.
+    ref.set_variable(var);
+    ref.pop_modifier();
+    ASTERIA_TEST_CHECK(ref.is_temporary());
+    ASTERIA_TEST_CHECK(ref.dereference_readonly().is_null());
+    ASTERIA_TEST_CHECK(var.use_count() == 1);
+
+    // Modifiers are copied, moved and swapped along with references,
+    // whether they are stored in place or not.
+    V_object obj;
+    obj.try_emplace(sref("key"), V_array(3, V_integer(7)));
+    var->initialize(V_array(1, obj));
+
+    ref.set_variable(var);
+    ref.push_modifier_array_index(0);
+    ASTERIA_TEST_CHECK(ref.count_modifiers() == 1);
+    ASTERIA_TEST_CHECK(ref.modifier(0).as_array_index() == 0);
+    ASTERIA_TEST_CHECK_CATCH(ref.modifier(1));
+    ref2 = ref;
+    ref.push_modifier_object_key(sref("key"));
+    ref.push_modifier_array_index(-1);
+    ASTERIA_TEST_CHECK(ref.count_modifiers() == 3);
+    ASTERIA_TEST_CHECK(ref.modifier(1).as_object_key() == sref("key"));
+    ASTERIA_TEST_CHECK(ref.dereference_readonly().as_integer() == 7);
+    ASTERIA_TEST_CHECK(ref2.count_modifiers() == 1);
+    ASTERIA_TEST_CHECK(ref2.dereference_readonly().is_object());
+
+    Reference ref3 = ::std::move(ref);
+    ASTERIA_TEST_CHECK(ref.count_modifiers() == 0);
+    ASTERIA_TEST_CHECK(ref3.count_modifiers() == 3);
+    ref3.swap(ref2);
+    ASTERIA_TEST_CHECK(ref2.dereference_readonly().as_integer() == 7);
+    ASTERIA_TEST_CHECK(ref3.dereference_readonly().is_object());
+    ref = ref2;
+    ref.pop_modifier();
+    ref.pop_modifier();
+    ASTERIA_TEST_CHECK(ref.dereference_readonly().is_object());
+    ASTERIA_TEST_CHECK(ref2.dereference_readonly().as_integer() == 7);
+
+    ref2.dereference_mutable() = V_integer(8);
+    ASTERIA_TEST_CHECK(ref2.dereference_unset().as_integer() == 8);
+    ref3.push_modifier_object_key(sref("key"));
+    ASTERIA_TEST_CHECK(ref3.dereference_readonly().as_array().size() == 2);
+    ref3.pop_modifier();
+    ASTERIA_TEST_CHECK(ref3.dereference_unset().is_object());
+    ASTERIA_TEST_CHECK(var->get_value().as_array().size() == 0);
+    ref.pop_modifier();
+    ASTERIA_TEST_CHECK_CATCH(ref.dereference_unset());
+    ref.clear_modifiers();
+    ref2.clear_modifiers();
+    ref3.clear_modifiers();
+
+    // A key is stored in place only for a variable. It is copied, moved and
+    // swapped along with the variable, and is moved into the vector when a
+    // second modifier is pushed.
+    var->initialize(obj);
+    ref.set_variable(var);
+    ref.push_modifier_object_key(sref("key"));
+    ASTERIA_TEST_CHECK(ref.count_modifiers() == 1);
+    ASTERIA_TEST_CHECK(ref.modifier(0).as_object_key() == sref("key"));
+    ref2 = ref;
+    ref3 = ::std::move(ref);
+    ref3.swap(ref);
+    ASTERIA_TEST_CHECK(ref.dereference_readonly().as_array().size() == 3);
+    ASTERIA_TEST_CHECK(ref2.dereference_readonly().as_array().size() == 3);
+    ASTERIA_TEST_CHECK(ref3.count_modifiers() == 0);
+
+    ref2.push_modifier_array_tail();
+    ASTERIA_TEST_CHECK(ref2.count_modifiers() == 2);
+    ASTERIA_TEST_CHECK(ref2.modifier(0).as_object_key() == sref("key"));
+    ASTERIA_TEST_CHECK(ref2.modifier(1).is_array_tail());
+    ASTERIA_TEST_CHECK(ref2.dereference_readonly().as_integer() == 7);
+    ref2.pop_modifier();
+    ASTERIA_TEST_CHECK(ref2.dereference_readonly().as_array().size() == 3);
+
+    ref.dereference_mutable().mut_array().emplace_back(V_integer(9));
+    ASTERIA_TEST_CHECK(ref.dereference_unset().as_array().size() == 4);
+    ASTERIA_TEST_CHECK(var->get_value().as_object().size() == 0);
+
+    // Replacing the variable drops its key.
+    ref.set_temporary(obj);
+    ASTERIA_TEST_CHECK(ref.count_modifiers() == 0);
+    ref.push_modifier_object_key(sref("key"));
+    ref.push_modifier_array_index(1);
+    ASTERIA_TEST_CHECK(ref.dereference_readonly().as_integer() == 7);
+    ref.set_variable(var);
+    ref.push_modifier_object_key(sref("key"));
+    ref.set_void();
+    ASTERIA_TEST_CHECK(ref.count_modifiers() == 0);
+
+    // A single modifier doesn't allocate memory, except a key on a reference
+    // which is not a variable, where there is no room for it, so `f().x`
+    // allocates a vector for its key.
+    size_t old_count = alloc_count;
+    ref.set_variable(var);
+    ref.push_modifier_object_key(sref("key"));
+    ref.pop_modifier();
+    ref.push_modifier_array_index(1);
+    ref.pop_modifier();
+    ref.set_temporary(obj);
+    ref.push_modifier_array_tail();
+    ref.pop_modifier();
+    ASTERIA_TEST_CHECK(alloc_count == old_count);
+
+    ref.push_modifier_object_key(sref("key"));
+    ASTERIA_TEST_CHECK(alloc_count == old_count + 1);
+    ASTERIA_TEST_CHECK(ref.dereference_readonly().as_array().size() == 3);
+    ref.set_void();
+  }
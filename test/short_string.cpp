@@ -0,0 +1,69 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2022, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/value.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    // Short strings are stored in place and are not shared.
+    cow_string a(sref("hello"));
+    a.mut(0) = 'j';
+    ASTERIA_TEST_CHECK(a == sref("jello"));
+    ASTERIA_TEST_CHECK(a.unique());
+
+    cow_string b = a;
+    ASTERIA_TEST_CHECK(b == sref("jello"));
+    ASTERIA_TEST_CHECK(b.data() != a.data());
+    b.mut(0) = 'h';
+    ASTERIA_TEST_CHECK(a == sref("jello"));
+    ASTERIA_TEST_CHECK(b == sref("hello"));
+
+    // A short string becomes a long one when it grows, and vice versa.
+    b += sref(", world");
+    ASTERIA_TEST_CHECK(b == sref("hello, world"));
+    cow_string c = b;
+    ASTERIA_TEST_CHECK(c.data() == b.data());
+    ASTERIA_TEST_CHECK(c.use_count() == 2);
+    c.erase(2);
+    ASTERIA_TEST_CHECK(c == sref("he"));
+    ASTERIA_TEST_CHECK(b == sref("hello, world"));
+
+    // Move, swap and assignment.
+    cow_string d = ::std::move(a);
+    ASTERIA_TEST_CHECK(d == sref("jello"));
+    ASTERIA_TEST_CHECK(a.empty());
+    d.swap(b);
+    ASTERIA_TEST_CHECK(d == sref("hello, world"));
+    ASTERIA_TEST_CHECK(b == sref("jello"));
+    b.swap(c);
+    ASTERIA_TEST_CHECK(b == sref("he"));
+    ASTERIA_TEST_CHECK(c == sref("jello"));
+    c = c;
+    ASTERIA_TEST_CHECK(c == sref("jello"));
+    c = b;
+    ASTERIA_TEST_CHECK(c == sref("he"));
+    c.insert(2, sref("llo"));
+    ASTERIA_TEST_CHECK(c == sref("hello"));
+    c.replace(1, 4, sref("i there, this is long"));
+    ASTERIA_TEST_CHECK(c == sref("hi there, this is long"));
+    ASTERIA_TEST_CHECK(*(c.c_str() + c.size()) == 0);
+
+    // Strings may be relocated bitwise, which is what `Value` does.
+    Value v1 = sref("x");
+    Value v2 = cow_string(1, 'y');
+    Value v3 = cow_string(sref("abc")).append(sref("def"));
+    v1.swap(v2);
+    v2.swap(v3);
+    ASTERIA_TEST_CHECK(v1.as_string() == sref("y"));
+    ASTERIA_TEST_CHECK(v2.as_string() == sref("abcdef"));
+    ASTERIA_TEST_CHECK(v3.as_string() == sref("x"));
+    ASTERIA_TEST_CHECK(::strcmp(v2.as_string().c_str(), "abcdef") == 0);
+
+    cow_vector<cow_string> strs;
+    for(int k = 0;  k < 1000;  ++k)
+      strs.emplace_back(format_string("$1", k));
+    for(int k = 0;  k < 1000;  ++k)
+      ASTERIA_TEST_CHECK(strs[static_cast<size_t>(k)] == format_string("$1", k));
+  }
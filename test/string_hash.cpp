@@ -0,0 +1,74 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2022, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    // Hash values shall not depend on how a string is split.
+    const char text[] = "The quick brown fox jumps over the lazy dog.";
+    const cow_string str(text);
+    const size_t hval = cow_string::hash()(str);
+    ASTERIA_TEST_CHECK(cow_string::hash()(text) == hval);
+
+    for(size_t k = 0;  k <= str.size();  ++k) {
+      ::rocket::details_cow_string::basic_hasher<char, ::rocket::char_traits<char>> hf;
+      hf.append(str.data(), k);
+      for(size_t i = k;  i < str.size();  ++i)
+        hf.append(str[i]);
+      ASTERIA_TEST_CHECK(hf.finish() == hval);
+    }
+
+    // Trailing null characters are significant.
+    ASTERIA_TEST_CHECK(cow_string::hash()(cow_string("a", 1)) != cow_string::hash()(cow_string("a\0", 2)));
+    ASTERIA_TEST_CHECK(cow_string::hash()(cow_string()) != cow_string::hash()(cow_string("\0", 1)));
+
+    // Generate keys whose lengths are distributed like identifiers and
+    // members of JSON objects, plus a few long strings.
+    cow_vector<cow_string> keys;
+    uint32_t seed = 12345;
+    for(int k = 0;  k < 100000;  ++k) {
+      seed = seed * 1103515245 + 12345;
+      size_t len = (seed >> 16) % 100;
+      if(len < 60)
+        len = 1 + len / 6;  // 1 - 10
+      else if(len < 95)
+        len = 11 + (len - 60) / 2;  // 11 - 28
+      else
+        len = 64 + (len - 95) * 32;  // 64 - 192
+
+      cow_string key;
+      for(size_t i = 0;  i < len;  ++i) {
+        seed = seed * 1103515245 + 12345;
+        key.push_back(static_cast<char>('a' + (seed >> 16) % 26));
+      }
+      key += ::rocket::sref("_");
+      key += format_string("$1", k);
+      keys.emplace_back(::std::move(key));
+    }
+
+    // Check that all bits are used. The number of keys in the fullest bucket
+    // shall be reasonable.
+    for(size_t shift : { size_t(0), size_t(11), size_t(22), sizeof(size_t) * 8 - 10 }) {
+      cow_vector<uint32_t> buckets(1024, 0);
+      for(const auto& key : keys)
+        buckets.mut((cow_string::hash()(key) >> shift) % 1024) ++;
+
+      uint32_t nmax = 0;
+      for(uint32_t n : buckets)
+        nmax = ::rocket::max(nmax, n);
+      ASTERIA_TEST_CHECK(nmax < keys.size() / 1024 * 3 / 2);
+    }
+
+    // Flipping any bit of the input shall flip about half of the output.
+    cow_string base = ::rocket::sref("some_member_name");
+    size_t hbase = cow_string::hash()(base);
+    for(size_t i = 0;  i < base.size() * 8;  ++i) {
+      cow_string flipped = base;
+      flipped.mut(i / 8) = static_cast<char>(flipped[i / 8] ^ (1 << i % 8));
+      int nbits = ::__builtin_popcountll(cow_string::hash()(flipped) ^ hbase);
+      ASTERIA_TEST_CHECK(nbits >= (int) sizeof(size_t) * 2);
+      ASTERIA_TEST_CHECK(nbits <= (int) sizeof(size_t) * 6);
+    }
+  }
@@ -0,0 +1,113 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2022, LH_Mouse. All wrongs reserved.
+
+#include "../asteria/fwd.hpp"
+#include "../asteria/utils.hpp"
+#include "../asteria/runtime/global_context.hpp"
+#include "../asteria/runtime/variable.hpp"
+#include <time.h>
+#include <math.h>
+using namespace ::asteria;
+
+// This is a benchmark, which is not run by `make check`. It compares the
+// 32-bit FNV-1a hash, which was used before, with `cow_string::hash`.
+
+static
+size_t
+do_fnv1a(const cow_string& str)
+  {
+    uint32_t reg = 0x811C9DC5;
+    for(char c : str)
+      reg = (reg ^ static_cast<unsigned char>(c)) * 0x1000193;
+    return reg;
+  }
+
+static
+double
+do_get_time() noexcept
+  {
+    ::timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec / 1.0e9;
+  }
+
+template<typename HashT>
+static
+double
+do_measure(const cow_vector<cow_string>& keys, HashT&& hash)
+  {
+    // Take the best of a few runs, which is the least disturbed one.
+    double best = HUGE_VAL;
+    size_t sum = 0;
+    for(int t = 0;  t < 5;  ++t) {
+      double start = do_get_time();
+      for(int r = 0;  r < 200;  ++r)
+        for(const auto& key : keys)
+          sum += hash(key);
+      best = ::rocket::min(best, do_get_time() - start);
+    }
+
+    // Prevent the loop from being optimized away.
+    if(sum == 1)
+      ::printf("unlikely\n");
+    return best * 1.0e9 / 200 / (double) keys.size();
+  }
+
+static
+void
+do_collect_keys(cow_vector<cow_string>& keys, const V_object& obj)
+  {
+    for(const auto& r : obj) {
+      keys.push_back(r.first.rdstr());
+      if(r.second.is_object())
+        do_collect_keys(keys, r.second.as_object());
+    }
+  }
+
+int main()
+  {
+    // Generate keys whose lengths are distributed like identifiers and
+    // members of JSON objects, plus a few long strings.
+    cow_vector<cow_string> keys;
+    uint32_t seed = 12345;
+    for(int k = 0;  k < 10000;  ++k) {
+      seed = seed * 1103515245 + 12345;
+      size_t len = (seed >> 16) % 100;
+      if(len < 60)
+        len = 1 + len / 6;  // 1 - 10
+      else if(len < 95)
+        len = 11 + (len - 60) / 2;  // 11 - 28
+      else
+        len = 64 + (len - 95) * 32;  // 64 - 192
+
+      cow_string key;
+      for(size_t i = 0;  i < len;  ++i) {
+        seed = seed * 1103515245 + 12345;
+        key.push_back(static_cast<char>('a' + (seed >> 16) % 26));
+      }
+      keys.emplace_back(::std::move(key));
+    }
+
+    // Short keys, medium keys and long keys are measured separately, then
+    // all of them together. They fit in the cache.
+    cow_vector<cow_string> groups[5];
+    for(const auto& key : keys) {
+      size_t g = (key.size() < 12) ? 0 : (key.size() < 40) ? 1 : 2;
+      if(groups[g].size() < 1000)
+        groups[g].push_back(key);
+      if(groups[3].size() < 1000)
+        groups[3].push_back(key);
+    }
+
+    // Names in the standard library are real-world keys.
+    Global_Context global;
+    do_collect_keys(groups[4], global.std_variable()->get_value().as_object());
+
+    static constexpr char names[][8] = { "short", "medium", "long", "mixed", "std" };
+    for(size_t g = 0;  g != 5;  ++g) {
+      double t_fnv = do_measure(groups[g], do_fnv1a);
+      double t_new = do_measure(groups[g], cow_string::hash());
+      ::printf("%-6s keys (%4zu): FNV-1a %6.2f ns/key, cow_string::hash %6.2f ns/key\n",
+               names[g], groups[g].size(), t_fnv, t_new);
+    }
+  }
@@ -0,0 +1,117 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2022, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+#include "../asteria/runtime/air_node.hpp"
+#include "../asteria/runtime/enums.hpp"
+#include "../asteria/llds/avmc_queue.hpp"
+using namespace ::asteria;
+
+static
+size_t
+do_count_nodes(const cow_vector<AIR_Node>& code, bool fused)
+  {
+    AVMC_Queue queue;
+    if(fused)
+      AIR_Node::solidify_all(queue, code);
+    else
+      for(const auto& node : code)
+        node.solidify(queue);
+    queue.finalize();
+    return queue.count_nodes();
+  }
+
+int main()
+  {
+    // Fused nodes shall behave the same as the nodes that they replace.
+    Simple_Script code;
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        var obj = { a = 1, b = { c = "x" } };
+        assert obj.a == 1;
+        assert obj.b.c == "x";
+        assert obj.d == null;
+        obj.d = 5;
+        assert obj.d == 5;
+
+        var n = 0;
+        for(var i = 0;  i < 10;  ++i)
+          n = n + 2;
+        assert n == 20;
+        n += 1;
+        assert n == 21;
+        var s = "a";
+        assert s + "b" == "ab";
+        assert s == "a";
+        s += "c";
+        assert s == "ac";
+        var r = 1.5;
+        assert r < 2;
+        assert r + 1 == 2.5;
+
+        try {
+          var x = 0x7FFFFFFFFFFFFFFF;
+          x = x + 1;
+          assert false;
+        }
+        catch(e)
+          assert std.string.find(e, "Integer addition overflow") != null;
+
+        try {
+          assert s < 1;
+          assert false;
+        }
+        catch(e)
+          assert std.string.find(e, "Values not comparable") != null;
+
+        func twice(x) { return x * 2;  }
+        assert twice(21) == 42;
+        func rec(k) { return (k < 1) ? 0 : rec(k - 1) + 1;  }
+        assert rec(10) == 10;
+
+        try {
+          var arr = [ 1 ];
+          arr.x;
+          assert false;
+        }
+        catch(e)
+          assert std.string.find(e, "String subscript not applicable") != null;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    code.execute();
+
+    // Check that each common sequence is fused into a single node. This is
+    // what `n + 2 < i` and `obj.a(1)` look like, where `n`, `i` and `obj` are
+    // local variables.
+    Source_Location sloc(sref("dummy file"), 1, 1);
+    AIR_Node::S_push_local_reference xlocal = { sloc, 0, 0, sref("n") };
+    AIR_Node::S_push_temporary xtemp = { 2 };
+    AIR_Node::S_apply_operator xadd = { sloc, xop_add, false };
+    AIR_Node::S_apply_operator xlt = { sloc, xop_cmp_lt, false };
+    AIR_Node::S_member_access xmemb = { sloc, sref("a") };
+    AIR_Node::S_function_call xcall = { sloc, 1, ptc_aware_none };
+
+    cow_vector<AIR_Node> seq;
+    seq.emplace_back(xlocal);
+    seq.emplace_back(xtemp);
+    seq.emplace_back(xadd);
+    xlocal.name = sref("i");
+    seq.emplace_back(xlocal);
+    seq.emplace_back(xlt);
+    ASTERIA_TEST_CHECK(do_count_nodes(seq, false) == 5);
+    ASTERIA_TEST_CHECK(do_count_nodes(seq, true) == 3);
+
+    seq.clear();
+    xlocal.name = sref("obj");
+    seq.emplace_back(xlocal);
+    seq.emplace_back(xmemb);
+    xtemp.value = 1;
+    seq.emplace_back(xtemp);
+    seq.emplace_back(xcall);
+    ASTERIA_TEST_CHECK(do_count_nodes(seq, false) == 4);
+    ASTERIA_TEST_CHECK(do_count_nodes(seq, true) == 2);
+  }
@@ -0,0 +1,115 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2022, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+#include "../asteria/runtime/air_node.hpp"
+#include "../asteria/runtime/executive_context.hpp"
+#include "../asteria/runtime/global_context.hpp"
+#include "../asteria/runtime/enums.hpp"
+#include "../asteria/llds/avmc_queue.hpp"
+#include "../asteria/llds/reference_stack.hpp"
+using namespace ::asteria;
+
+static
+Value
+do_add(const AVMC_Queue& queue, Executive_Context& ctx, const Value& lhs, const Value& rhs)
+  {
+    ctx.stack().clear();
+    ctx.stack().push().set_temporary(lhs);
+    ctx.stack().push().set_temporary(rhs);
+    queue.execute(ctx);
+    return ctx.stack().top().dereference_readonly();
+  }
+
+int main()
+  {
+    // Nodes that have been specialized for some types shall still accept
+    // operands of other types.
+    Simple_Script code;
+    code.reload_string(
+      sref(__FILE__), __LINE__, sref(R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func add(x, y) { return x + y;  }
+        func sub(x, y) { return x - y;  }
+        func mul(x, y) { return x * y;  }
+        func lt(x, y) { return x < y;  }
+        func gte(x, y) { return x >= y;  }
+
+        assert add(1, 2) == 3;
+        assert add(1.5, 2.5) == 4.0;
+        assert add(1, 2.5) == 3.5;
+        assert add("a", "b") == "ab";
+        assert add(true, false) == true;
+
+        assert sub(1.5, 0.5) == 1.0;
+        assert sub(5, 7) == -2;
+        assert sub(false, true) == true;
+
+        assert mul(3, 4) == 12;
+        assert mul("ab", 2) == "abab";
+        assert mul(0.5, 4) == 2.0;
+
+        assert lt(1, 2) == true;
+        assert lt(2.0, 1.0) == false;
+        assert lt("a", "b") == true;
+        assert gte(2, 2) == true;
+        assert gte(1.0, 2) == false;
+
+        try {
+          add(0x7FFFFFFFFFFFFFFF, 1);
+          assert false;
+        }
+        catch(e)
+          assert std.string.find(e, "Integer addition overflow") != null;
+
+        try {
+          lt(1.0, nan);
+          assert false;
+        }
+        catch(e)
+          assert std.string.find(e, "Values not comparable") != null;
+
+        try {
+          lt(1, "a");
+          assert false;
+        }
+        catch(e)
+          assert std.string.find(e, "Values not comparable") != null;
+
+        var n = 0;
+        for(var i = 0;  i < 10;  ++i)
+          n += i * i;
+        assert n == 285;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__"));
+    code.execute();
+
+    // A node shall be specialized on its first execution, and shall not be
+    // specialized again, even if it has been compiled into native code.
+    Global_Context global;
+    Reference_Stack stack, alt_stack;
+    Executive_Context ctx(Executive_Context::M_defer(), global, stack, alt_stack,
+                          cow_bivector<Source_Location, AVMC_Queue>());
+
+    AVMC_Queue queue;
+    AIR_Node::S_apply_operator xadd = { Source_Location(sref("dummy file"), 1, 1), xop_add, false };
+    AIR_Node(xadd).solidify(queue);
+    queue.finalize();
+    queue.jit_compile();
+    auto exec_feedback = queue.get_executor(0);
+
+    for(int64_t i = 0;  i < 100;  ++i)
+      ASTERIA_TEST_CHECK(do_add(queue, ctx, i, 1).as_integer() == i + 1);
+
+    auto exec_integer = queue.get_executor(0);
+    ASTERIA_TEST_CHECK(exec_integer != exec_feedback);
+
+    // Other types of operands take the generic path.
+    ASTERIA_TEST_CHECK(do_add(queue, ctx, 2.5, 1.0).as_real() == 3.5);
+    ASTERIA_TEST_CHECK(do_add(queue, ctx, sref("a"), sref("b")).as_string() == "ab");
+    ASTERIA_TEST_CHECK(queue.get_executor(0) == exec_integer);
+    ASTERIA_TEST_CHECK(do_add(queue, ctx, 40, 2).as_integer() == 42);
+  }
@@ -0,0 +1,47 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2022, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/llds/variable_slab.hpp"
+#include "../asteria/runtime/variable.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    cow_vector<refcnt_ptr<Variable>> vars;
+    refcnt_ptr<Variable> orphan;
+    {
+      Variable_Slab slab;
+      for(int k = 0;  k != 1000;  ++k) {
+        vars.emplace_back(new(slab) Variable());
+        vars.back()->initialize(V_integer(k));
+      }
+      size_t nchunks = slab.count_chunks();
+      ASTERIA_TEST_CHECK(nchunks > 1);
+
+      // Freed slots shall be reused.
+      vars.erase(vars.begin() + 100, vars.begin() + 200);
+      for(int k = 0;  k != 100;  ++k)
+        vars.emplace_back(new(slab) Variable());
+      ASTERIA_TEST_CHECK(slab.count_chunks() == nchunks);
+
+      // Empty chunks shall be released, except one.
+      orphan = vars.back();
+      vars.clear();
+      ASTERIA_TEST_CHECK(slab.count_chunks() <= 2);
+
+      for(int k = 0;  k != 1000;  ++k)
+        ASTERIA_TEST_CHECK(vars.emplace_back(new(slab) Variable())->is_uninitialized());
+      vars.clear();
+    }
+
+    // This variable outlives its slab.
+    orphan->initialize(V_string(sref("meow")));
+    ASTERIA_TEST_CHECK(orphan->get_value().as_string() == "meow");
+    orphan = nullptr;
+
+    // Variables that don't belong to any slab are allocated from the heap.
+    auto var = ::rocket::make_refcnt<Variable>();
+    var->initialize(V_real(1.5));
+    ASTERIA_TEST_CHECK(var->get_value().as_real() == 1.5);
+  }